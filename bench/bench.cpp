@@ -0,0 +1,112 @@
+#include "bench.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+
+namespace fck::bench
+{
+
+Runner::Runner(const Options &options) : m_options{options}
+{
+}
+
+const Options &Runner::getOptions() const
+{
+    return m_options;
+}
+
+bool Runner::isSelected(const std::string &name) const
+{
+    return m_options.filter.empty() || name.find(m_options.filter) != std::string::npos;
+}
+
+void Runner::addResult(const std::string &name, std::vector<double> times)
+{
+    if (times.empty())
+    {
+        spdlog::warn("Benchmark {} has no iterations", name);
+        return;
+    }
+
+    std::sort(times.begin(), times.end());
+
+    Result result;
+    result.name = name;
+    result.iterations = times.size();
+    result.total_time = std::accumulate(times.begin(), times.end(), 0.0);
+    result.mean_time = result.total_time / times.size();
+    result.min_time = times.front();
+    result.median_time = times[times.size() / 2];
+    result.max_time = times.back();
+
+    spdlog::info(
+        "{}: {} iterations, mean {:.4f} ms, median {:.4f} ms, min {:.4f} ms, max {:.4f} ms",
+        result.name,
+        result.iterations,
+        result.mean_time,
+        result.median_time,
+        result.min_time,
+        result.max_time);
+
+    m_results.push_back(result);
+}
+
+const std::vector<Result> &Runner::getResults() const
+{
+    return m_results;
+}
+
+bool Runner::writeJson(const std::string &file_name) const
+{
+    std::ofstream file{file_name};
+    if (!file.is_open())
+    {
+        spdlog::warn("Can't open file to write benchmark results: {}", file_name);
+        return false;
+    }
+
+    file << std::fixed << std::setprecision(6);
+    file << "{\n  \"options\": {\"enemies_count\": " << m_options.enemies_count
+         << ", \"ticks_count\": " << m_options.ticks_count << "},\n";
+    file << "  \"benchmarks\": [";
+
+    for (std::size_t i = 0; i < m_results.size(); ++i)
+    {
+        const Result &result = m_results[i];
+
+        // Names are made by benchmarks, they have no characters to escape
+        file << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << result.name
+             << "\", \"iterations\": " << result.iterations
+             << ", \"total_ms\": " << result.total_time << ", \"mean_ms\": " << result.mean_time
+             << ", \"min_ms\": " << result.min_time << ", \"median_ms\": " << result.median_time
+             << ", \"max_ms\": " << result.max_time << "}";
+    }
+
+    file << "\n  ]\n}\n";
+
+    spdlog::info("Benchmark results written: {}", file_name);
+    return true;
+}
+
+bool Suites::registerSuite(const std::string &name, const std::function<void(Runner &)> &function)
+{
+    instance().m_suites.push_back({name, function});
+    return true;
+}
+
+const std::vector<Suites::Suite> &Suites::getSuites()
+{
+    return instance().m_suites;
+}
+
+Suites &Suites::instance()
+{
+    static Suites suites;
+    return suites;
+}
+
+} // namespace fck::bench
@@ -0,0 +1,130 @@
+#ifndef BENCH_KPWZRMTQEXAV_H
+#define BENCH_KPWZRMTQEXAV_H
+
+#include "../src/fck/profiler.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace fck::bench
+{
+
+#define REGISTER_BENCHMARK_SUITE(_name_, _function_) \
+    static const bool bench_suite_##_function_ \
+        = ::fck::bench::Suites::registerSuite(_name_, _function_)
+
+struct Result
+{
+    std::string name;
+    int32_t iterations;
+    // ms
+    double total_time;
+    double mean_time;
+    double min_time;
+    double median_time;
+    double max_time;
+};
+
+struct Options
+{
+    // Benchmarks with name without filter substring are skipped
+    std::string filter;
+    std::string level_file_name = "resources/levels/l1.tmx";
+    int32_t enemies_count = 100;
+    int32_t ticks_count = 600;
+};
+
+// Times measured functions and collects results of benchmarks
+class Runner
+{
+public:
+    Runner(const Options &options);
+    ~Runner() = default;
+
+    const Options &getOptions() const;
+
+    bool isSelected(const std::string &name) const;
+
+    // Every call of function is timed, setup called before each call is not
+    template<typename Setup, typename Function>
+    void measure(const std::string &name, int32_t iterations, Setup &&setup, Function &&function);
+
+    template<typename Function>
+    void measure(const std::string &name, int32_t iterations, Function &&function);
+
+    // Times of iterations measured by benchmark itself
+    void addResult(const std::string &name, std::vector<double> times);
+
+    const std::vector<Result> &getResults() const;
+
+    bool writeJson(const std::string &file_name) const;
+
+private:
+    Options m_options;
+
+    std::vector<Result> m_results;
+};
+
+class Suites
+{
+public:
+    struct Suite
+    {
+        std::string name;
+        std::function<void(Runner &)> function;
+    };
+
+    static bool registerSuite(
+        const std::string &name, const std::function<void(Runner &)> &function);
+    static const std::vector<Suite> &getSuites();
+
+private:
+    Suites() = default;
+    ~Suites() = default;
+
+    static Suites &instance();
+
+private:
+    std::vector<Suite> m_suites;
+};
+
+// Keeps value computed by benchmark from being optimized away
+template<typename T>
+void doNotOptimize(const T &value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+template<typename Setup, typename Function>
+void Runner::measure(
+    const std::string &name, int32_t iterations, Setup &&setup, Function &&function)
+{
+    if (!isSelected(name))
+        return;
+
+    std::vector<double> times;
+    times.reserve(iterations);
+
+    for (int32_t i = 0; i < iterations; ++i)
+    {
+        setup();
+
+        int64_t begin = Profiler::now();
+        function();
+        times.push_back(double(Profiler::now() - begin) / 1000000);
+    }
+
+    addResult(name, std::move(times));
+}
+
+template<typename Function>
+void Runner::measure(const std::string &name, int32_t iterations, Function &&function)
+{
+    measure(name, iterations, []() {}, std::forward<Function>(function));
+}
+
+} // namespace fck::bench
+
+#endif // BENCH_KPWZRMTQEXAV_H
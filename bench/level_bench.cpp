@@ -0,0 +1,89 @@
+#include "bench.h"
+
+#include "../src/fck_game.h"
+#include "../src/settings.h"
+
+#include <spdlog/spdlog.h>
+
+#include <filesystem>
+
+namespace fck::bench
+{
+
+namespace
+{
+
+// Headless game that times ticks of level and exits after given count of them
+class LevelBenchGame : public FckGame
+{
+public:
+    LevelBenchGame(int32_t ticks_count) : m_ticks_count{ticks_count}
+    {
+        m_tick_times.reserve(ticks_count);
+    }
+
+    std::vector<double> &getTickTimes()
+    {
+        return m_tick_times;
+    }
+
+protected:
+    void update(const sf::Time &elapsed)
+    {
+        bool level = getState() == game_state::LEVEL;
+
+        int64_t begin = Profiler::now();
+        FckGame::update(elapsed);
+        double time = double(Profiler::now() - begin) / 1000000;
+
+        if (!level || getState() != game_state::LEVEL)
+            return;
+
+        m_tick_times.push_back(time);
+        if (int32_t(m_tick_times.size()) >= m_ticks_count)
+            exit();
+    }
+
+private:
+    int32_t m_ticks_count;
+    std::vector<double> m_tick_times;
+};
+
+void levelBenchmarks(Runner &runner)
+{
+    const Options &options = runner.getOptions();
+    std::string name = "FckGame level tick, " + std::to_string(options.enemies_count) + " enemies";
+
+    if (!runner.isSelected(name))
+        return;
+
+    auto settings = std::make_shared<Settings>();
+    if (!std::filesystem::exists(settings->resources_database_name))
+    {
+        spdlog::warn(
+            "Level benchmark skipped, no resources database: {}",
+            settings->resources_database_name);
+        return;
+    }
+
+    settings->headless = true;
+    // Loading ticks go before level, limit stops game if level is never reached
+    settings->headless_ticks = options.ticks_count + 1000;
+    settings->level_enemies_count = options.enemies_count;
+    settings->random_seed = 1;
+    Settings::setGlobal(settings);
+
+    // Game resets static signals of entity_funcs and script factories when destroyed, so
+    // suites run after this one don't reach its systems and lua state
+    LevelBenchGame game{options.ticks_count};
+    game.init();
+    game.exec();
+
+    runner.addResult(name, std::move(game.getTickTimes()));
+}
+
+} // namespace
+
+REGISTER_BENCHMARK_SUITE("level", levelBenchmarks);
+
+} // namespace fck::bench
@@ -0,0 +1,42 @@
+#include "bench.h"
+
+#include <spdlog/spdlog.h>
+
+#include <string>
+
+int main(int argc, char *argv[])
+{
+    spdlog::set_level(spdlog::level::info);
+
+    fck::bench::Options options;
+    std::string output_file_name = "bench_results.json";
+
+    // [--filter NAME] [--output FILE] [--level FILE] [--enemies N] [--ticks N]
+    for (int32_t i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "--filter" && i + 1 < argc)
+            options.filter = argv[++i];
+        else if (arg == "--output" && i + 1 < argc)
+            output_file_name = argv[++i];
+        else if (arg == "--level" && i + 1 < argc)
+            options.level_file_name = argv[++i];
+        else if (arg == "--enemies" && i + 1 < argc)
+            options.enemies_count = std::stoi(argv[++i]);
+        else if (arg == "--ticks" && i + 1 < argc)
+            options.ticks_count = std::stoi(argv[++i]);
+        else
+            spdlog::warn("Unknown argument: {}", arg);
+    }
+
+    fck::bench::Runner runner{options};
+
+    for (const fck::bench::Suites::Suite &suite : fck::bench::Suites::getSuites())
+    {
+        spdlog::info("Suite: {}", suite.name);
+        suite.function(runner);
+    }
+
+    return runner.writeJson(output_file_name) ? 0 : 1;
+}
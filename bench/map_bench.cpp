@@ -0,0 +1,229 @@
+#include "bench.h"
+
+#include "../src/fck/a_star.h"
+#include "../src/fck/b2_dynamic_tree.h"
+#include "../src/fck/noise.h"
+#include "../src/fck/random.h"
+#include "../src/fck/tmx.h"
+#include "../src/fck/world.h"
+#include "../src/map/factory.h"
+
+#include <spdlog/spdlog.h>
+
+#include <memory>
+
+namespace fck::bench
+{
+
+namespace
+{
+
+const int32_t PATHS_PER_GRID = 50;
+
+struct PathQuery
+{
+    const Vector2D<int32_t> *walls;
+    sf::Vector2i source;
+    sf::Vector2i target;
+};
+
+// Walls on border and random walls inside, like chunk walls of level
+Vector2D<int32_t> createWalls(const sf::Vector2i &size, float walls_density)
+{
+    Vector2D<int32_t> walls{size};
+
+    for (int32_t i = 0; i < int32_t(walls.getSize()); ++i)
+    {
+        sf::Vector2i coords = walls.transformIndex(i);
+        bool border = coords.x == 0 || coords.y == 0 || coords.x == size.x - 1
+            || coords.y == size.y - 1;
+        walls[i] = border || Random::uniformReal(0.0f, 1.0f) < walls_density ? 1 : 0;
+    }
+
+    return walls;
+}
+
+void addPathQueries(const Vector2D<int32_t> &walls, std::vector<PathQuery> &queries)
+{
+    std::vector<sf::Vector2i> free_cells;
+    for (int32_t i = 0; i < int32_t(walls.getSize()); ++i)
+    {
+        if (walls.at(i) == 0)
+            free_cells.push_back(walls.transformIndex(i));
+    }
+
+    if (free_cells.size() < 2)
+        return;
+
+    for (int32_t i = 0; i < PATHS_PER_GRID; ++i)
+    {
+        queries.push_back(
+            {&walls,
+             free_cells[Random::uniformInt(0, int32_t(free_cells.size() - 1))],
+             free_cells[Random::uniformInt(0, int32_t(free_cells.size() - 1))]});
+    }
+}
+
+void measureFindPath(
+    Runner &runner,
+    const std::string &name,
+    const std::vector<PathQuery> &queries,
+    PathFinder::Algorithm algorithm = PathFinder::A_STAR)
+{
+    runner.measure(name, 10, [&]() {
+        std::size_t length = 0;
+        PathFinder path_finder;
+        path_finder.setAlgorithm(algorithm);
+        for (const PathQuery &query : queries)
+        {
+            // Queries of same grid are together, jump distances are built once per grid
+            if (path_finder.getWalls() != query.walls)
+                path_finder.setWalls(*query.walls);
+            length += path_finder.findPath(query.source, query.target).size();
+        }
+        doNotOptimize(length);
+    });
+}
+
+void mapBenchmarks(Runner &runner)
+{
+    Random::setSeed(1);
+
+    // Same setup as random chunks of map factory
+    runner.measure("noise::MapGenerator generate 100x100", 50, []() {
+        noise::RigedMulti riged_multi;
+        riged_multi.setFrequency(5);
+        riged_multi.setOctaveCount(1);
+        riged_multi.setLacunarity(2);
+        riged_multi.setSeed(1);
+
+        noise::Map noise_map;
+        noise::MapGenerator map_generator;
+        map_generator.setModule(&riged_multi);
+        map_generator.setMap(&noise_map);
+        map_generator.setDestSize(100, 100);
+        map_generator.setBounds(0, 5, 0, 5);
+        map_generator.generate();
+    });
+
+    // Synthetic grids work without level resources
+    Vector2D<int32_t> synthetic_walls = createWalls({64, 64}, 0.2f);
+    std::vector<PathQuery> synthetic_queries;
+    addPathQueries(synthetic_walls, synthetic_queries);
+    measureFindPath(runner, "PathFinder::findPath 64x64 random walls", synthetic_queries);
+    measureFindPath(
+        runner,
+        "PathFinder::findPath JPS 64x64 random walls",
+        synthetic_queries,
+        PathFinder::JUMP_POINT_SEARCH);
+
+    Vector2D<int32_t> arena_walls = createWalls({64, 64}, 0.02f);
+    std::vector<PathQuery> arena_queries;
+    addPathQueries(arena_walls, arena_queries);
+    measureFindPath(runner, "PathFinder::findPath 64x64 open arena", arena_queries);
+    measureFindPath(
+        runner,
+        "PathFinder::findPath JPS 64x64 open arena",
+        arena_queries,
+        PathFinder::JUMP_POINT_SEARCH);
+
+    const std::string &level_file_name = runner.getOptions().level_file_name;
+
+    Tmx tmx;
+    if (!tmx.loadFromFile(level_file_name))
+    {
+        spdlog::warn("Level benchmarks skipped, can't load level: {}", level_file_name);
+        return;
+    }
+
+    runner.measure("Tmx::loadFromFile", 20, [&]() {
+        Tmx level_tmx;
+        doNotOptimize(level_tmx.loadFromFile(level_file_name));
+    });
+
+    World world;
+    b2::DynamicTree<Entity> scene_tree;
+    std::unique_ptr<map::Map> map;
+
+    runner.measure(
+        "map::Factory::createMap 30 chunks",
+        5,
+        [&]() {
+            map.reset();
+            world.destroyAllEntities();
+            world.refresh();
+            Random::setSeed(1);
+        },
+        [&]() {
+            map::Factory map_factory{&world, &scene_tree};
+            map.reset(map_factory.createMap(30, level_file_name));
+        });
+
+    if (!map)
+        return;
+
+    // Wall grids of generated chunks, same for same seed
+    std::vector<PathQuery> chunk_queries;
+    const Vector2D<map::Chunk *> &chunks = map->getChunks();
+    for (int32_t i = 0; i < int32_t(chunks.getSize()); ++i)
+    {
+        if (chunks.at(i))
+            addPathQueries(chunks.at(i)->getWalls(), chunk_queries);
+    }
+
+    measureFindPath(runner, "PathFinder::findPath chunk walls", chunk_queries);
+    measureFindPath(
+        runner,
+        "PathFinder::findPath JPS chunk walls",
+        chunk_queries,
+        PathFinder::JUMP_POINT_SEARCH);
+
+    if (chunk_queries.empty())
+        return;
+
+    // Queries between random free cells of random chunks
+    std::vector<std::pair<map::PathPlanner::Waypoint, map::PathPlanner::Waypoint>>
+        planner_queries;
+    for (int32_t i = 0; i < PATHS_PER_GRID; ++i)
+    {
+        const PathQuery &source_query
+            = chunk_queries[Random::uniformInt(0, int32_t(chunk_queries.size() - 1))];
+        const PathQuery &target_query
+            = chunk_queries[Random::uniformInt(0, int32_t(chunk_queries.size() - 1))];
+
+        auto chunkCoords = [&chunks](const Vector2D<int32_t> *walls) {
+            for (int32_t j = 0; j < int32_t(chunks.getSize()); ++j)
+            {
+                if (chunks.at(j) && &chunks.at(j)->getWalls() == walls)
+                    return chunks.transformIndex(j);
+            }
+            return sf::Vector2i{};
+        };
+
+        planner_queries.push_back(
+            {{chunkCoords(source_query.walls), source_query.source},
+             {chunkCoords(target_query.walls), target_query.target}});
+    }
+
+    map::PathPlanner &path_planner = map->getPathPlanner();
+
+    runner.measure(
+        "map::PathPlanner::build 30 chunks", 10, [&]() { path_planner.build(map.get()); });
+
+    runner.measure("map::PathPlanner::findPath across chunks", 10, [&]() {
+        std::size_t length = 0;
+        for (const auto &[source, target] : planner_queries)
+        {
+            std::vector<map::PathPlanner::Waypoint> path = path_planner.findPath(source, target);
+            if (!path.empty())
+                length += path_planner.refinePath(path, source).size();
+        }
+        doNotOptimize(length);
+    });
+}
+
+} // namespace
+
+REGISTER_BENCHMARK_SUITE("map", mapBenchmarks);
+
+} // namespace fck::bench
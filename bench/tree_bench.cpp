@@ -0,0 +1,141 @@
+#include "bench.h"
+
+#include "../src/fck/b2_dynamic_tree.h"
+#include "../src/fck/random.h"
+
+#include <memory>
+
+namespace fck::bench
+{
+
+namespace
+{
+
+const int32_t PROXIES_COUNT = 10000;
+const int32_t QUERIES_COUNT = 1000;
+const float AREA_SIZE = 4000.0f;
+const sf::Vector2f PROXY_SIZE = {16.0f, 16.0f};
+
+std::vector<b2::AABB> createAABBs(int32_t count)
+{
+    std::vector<b2::AABB> aabbs;
+    aabbs.reserve(count);
+
+    for (int32_t i = 0; i < count; ++i)
+    {
+        sf::Vector2f position
+            = {Random::uniformReal(0.0f, AREA_SIZE), Random::uniformReal(0.0f, AREA_SIZE)};
+        aabbs.push_back(sf::FloatRect{position, PROXY_SIZE});
+    }
+
+    return aabbs;
+}
+
+void treeBenchmarks(Runner &runner)
+{
+    Random::setSeed(1);
+
+    std::vector<b2::AABB> aabbs = createAABBs(PROXIES_COUNT);
+    std::vector<int32_t> user_data(PROXIES_COUNT);
+    for (int32_t i = 0; i < PROXIES_COUNT; ++i)
+        user_data[i] = i;
+
+    std::unique_ptr<b2::DynamicTree<int32_t>> tree;
+    std::vector<int32_t> proxy_ids;
+
+    runner.measure(
+        "DynamicTree createProxy 10k",
+        20,
+        [&]() { tree = std::make_unique<b2::DynamicTree<int32_t>>(); },
+        [&]() {
+            for (int32_t i = 0; i < PROXIES_COUNT; ++i)
+                tree->createProxy(aabbs[i], i);
+        });
+
+    runner.measure(
+        "DynamicTree createProxies 10k",
+        20,
+        [&]() { tree = std::make_unique<b2::DynamicTree<int32_t>>(); },
+        [&]() { proxy_ids = tree->createProxies(aabbs, user_data); });
+
+    // Moves and queries need filled tree even if creating benchmarks are skipped by filter
+    auto fill_tree = [&]() {
+        if (tree && !proxy_ids.empty())
+            return;
+        tree = std::make_unique<b2::DynamicTree<int32_t>>();
+        proxy_ids = tree->createProxies(aabbs, user_data);
+    };
+
+    // Small moves, most proxies stay inside fat AABB
+    std::vector<b2::AABB> moved_aabbs(PROXIES_COUNT);
+    std::vector<sf::Vector2f> displacements(PROXIES_COUNT);
+
+    auto prepare_moves = [&](float max_offset) {
+        for (int32_t i = 0; i < PROXIES_COUNT; ++i)
+        {
+            displacements[i] = {
+                Random::uniformReal(-max_offset, max_offset),
+                Random::uniformReal(-max_offset, max_offset)};
+            aabbs[i].lower_bound += displacements[i];
+            aabbs[i].upper_bound += displacements[i];
+            moved_aabbs[i] = aabbs[i];
+        }
+    };
+
+    runner.measure(
+        "DynamicTree moveProxy 10k small",
+        100,
+        [&]() {
+            fill_tree();
+            prepare_moves(1.0f);
+        },
+        [&]() {
+            for (int32_t i = 0; i < PROXIES_COUNT; ++i)
+                tree->moveProxy(proxy_ids[i], moved_aabbs[i], displacements[i]);
+        });
+
+    runner.measure(
+        "DynamicTree moveProxies 10k small",
+        100,
+        [&]() {
+            fill_tree();
+            prepare_moves(1.0f);
+        },
+        [&]() { tree->moveProxies(proxy_ids, moved_aabbs, displacements); });
+
+    runner.measure(
+        "DynamicTree moveProxies 10k large",
+        100,
+        [&]() {
+            fill_tree();
+            prepare_moves(32.0f);
+        },
+        [&]() { tree->moveProxies(proxy_ids, moved_aabbs, displacements); });
+
+    std::vector<b2::AABB> query_aabbs;
+    query_aabbs.reserve(QUERIES_COUNT);
+    for (int32_t i = 0; i < QUERIES_COUNT; ++i)
+    {
+        sf::Vector2f position
+            = {Random::uniformReal(0.0f, AREA_SIZE), Random::uniformReal(0.0f, AREA_SIZE)};
+        query_aabbs.push_back(sf::FloatRect{position, {128.0f, 128.0f}});
+    }
+
+    runner.measure("DynamicTree querry 1k in 10k", 100, fill_tree, [&]() {
+        int32_t count = 0;
+        for (const b2::AABB &query_aabb : query_aabbs)
+        {
+            tree->querry(query_aabb, [&count](int32_t proxy_id) {
+                ++count;
+                return true;
+            });
+        }
+        doNotOptimize(count);
+    });
+}
+
+} // namespace
+
+REGISTER_BENCHMARK_SUITE("tree", treeBenchmarks);
+
+} // namespace fck::bench
@@ -0,0 +1,158 @@
+#include "bench.h"
+
+#include "../src/components/components.h"
+#include "../src/entity_funcs.h"
+#include "../src/fck/b2_dynamic_tree.h"
+#include "../src/fck/random.h"
+#include "../src/fck/world.h"
+#include "../src/map/factory.h"
+#include "../src/systems/movement.h"
+
+#include <spdlog/spdlog.h>
+
+#include <memory>
+
+namespace fck::bench
+{
+
+namespace
+{
+
+const int32_t ENTITIES_COUNT = 10000;
+
+void createEntities(World &world, int32_t count)
+{
+    for (Entity &entity : world.createEntities(count))
+    {
+        entity.add<component::Transform>();
+        component::Velocity &velocity_component = entity.add<component::Velocity>();
+        velocity_component.velocity = {1.0f, 1.0f};
+        entity.enable();
+    }
+}
+
+// Save and rewind of whole world, restore rewinds to same snapshot every iteration
+void measureSnapshot(Runner &runner, World &world, const std::string &name)
+{
+    std::vector<char> snapshot;
+
+    runner.measure("World::saveSnapshot " + name, 20, [&]() {
+        snapshot = world.saveSnapshot();
+        doNotOptimize(snapshot.size());
+    });
+
+    runner.measure("World::restoreSnapshot " + name, 20, [&]() {
+        doNotOptimize(world.restoreSnapshot(snapshot));
+    });
+}
+
+void worldBenchmarks(Runner &runner)
+{
+    World world;
+    system::Movement movement_system;
+    world.addSystem(movement_system);
+
+    // Churn, systems get entities on refresh
+    runner.measure(
+        "World create 10k",
+        50,
+        [&]() {
+            world.destroyAllEntities();
+            world.refresh();
+        },
+        [&]() {
+            createEntities(world, ENTITIES_COUNT);
+            world.refresh();
+        });
+
+    runner.measure(
+        "World destroy 10k",
+        50,
+        [&]() {
+            world.destroyAllEntities();
+            world.refresh();
+            createEntities(world, ENTITIES_COUNT);
+            world.refresh();
+        },
+        [&]() {
+            world.destroyAllEntities();
+            world.refresh();
+        });
+
+    runner.measure(
+        "World destroy 1k of 10k",
+        50,
+        [&]() {
+            world.destroyAllEntities();
+            world.refresh();
+            createEntities(world, ENTITIES_COUNT);
+            world.refresh();
+        },
+        [&]() {
+            std::vector<Entity> entities = world.getEntities();
+            for (std::size_t i = 0; i < entities.size(); i += 10)
+                entities[i].destroy();
+            world.refresh();
+        });
+
+    runner.measure("World refresh 10k idle", 1000, [&]() { world.refresh(); });
+
+    // Iteration
+    world.destroyAllEntities();
+    world.refresh();
+    createEntities(world, ENTITIES_COUNT);
+    world.refresh();
+
+    runner.measure("View each 10k Transform Velocity", 1000, [&]() {
+        float sum = 0;
+        world.view<component::Transform, component::Velocity>().each(
+            [&sum](
+                Entity &entity,
+                component::Transform &transform_component,
+                component::Velocity &velocity_component) { sum += velocity_component.velocity.x; });
+        doNotOptimize(sum);
+    });
+
+    runner.measure("View changed 10k Velocity, none changed", 1000, [&]() {
+        int32_t count = 0;
+        world.view<component::Velocity>().changed<component::Velocity>(world.getTick()).each(
+            [&count](Entity &entity, component::Velocity &velocity_component) { ++count; });
+        doNotOptimize(count);
+    });
+
+    runner.measure("system::Movement update 10k", 1000, [&]() {
+        movement_system.update(1.0 / 60);
+        entity_funcs::flushMoved();
+    });
+
+    measureSnapshot(runner, world, "10k Transform Velocity");
+
+    world.destroyAllEntities();
+    world.refresh();
+    world.removeAllSystems();
+
+    const std::string &level_file_name = runner.getOptions().level_file_name;
+
+    Random::setSeed(1);
+    b2::DynamicTree<Entity> scene_tree;
+    map::Factory map_factory{&world, &scene_tree};
+    std::unique_ptr<map::Map> map{map_factory.createMap(30, level_file_name)};
+    if (!map)
+    {
+        spdlog::warn("Map snapshot benchmarks skipped, can't create map: {}", level_file_name);
+        return;
+    }
+
+    world.refresh();
+    measureSnapshot(runner, world, "map 30 chunks");
+
+    map.reset();
+    world.destroyAllEntities();
+    world.refresh();
+}
+
+} // namespace
+
+REGISTER_BENCHMARK_SUITE("world", worldBenchmarks);
+
+} // namespace fck::bench
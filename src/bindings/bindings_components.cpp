@@ -15,6 +15,8 @@ void bindComponentsToLua(sol::state &sol_state, sol::usertype<Entity> &entity_bi
             sol::constructors<component::Transform()>(),
             "transform",
             &component::Transform::transform,
+            "local_position",
+            &component::Transform::local_position,
             "parent",
             &component::Transform::parent,
             "children",
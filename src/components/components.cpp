@@ -1,14 +1,13 @@
 #include "components.h"
+#include "../fck/tile_map.h"
 #include "../knowledge_base/drawable_factory.h"
 
 namespace fck::component
 {
 
 // TRANSFORM
-void TransformComponentFactory::create(Entity &entity)
+void TransformComponentFactory::init(toml::table &component_table)
 {
-    auto &component = entity.add<Transform>();
-
     if (component_table.contains("position"))
         component.transform.setPosition(
             vector2::tomlArrayToVector2f(component_table.at("position").as_array()));
@@ -22,26 +21,71 @@ void TransformComponentFactory::create(Entity &entity)
             vector2::tomlArrayToVector2f(component_table.at("scale").as_array()));
 
     if (component_table.contains("origin"))
-        component.transform.setScale(
+        component.transform.setOrigin(
             vector2::tomlArrayToVector2f(component_table.at("origin").as_array()));
 }
 
-// VELOCITY
-void VelocityComponentFactory::create(Entity &entity)
+void TransformComponentFactory::create(Entity &entity)
+{
+    entity.add<Transform>(component);
+}
 
+void serialize(SnapshotWriter &writer, const Transform &component)
 {
-    component::Velocity &component = entity.add<Velocity>();
+    writer.write(component.transform.getPosition());
+    writer.write(component.transform.getRotation().asDegrees());
+    writer.write(component.transform.getScale());
+    writer.write(component.transform.getOrigin());
+    writer.write(component.local_position);
+
+    writer.writeEntity(component.parent);
+    writer.write(uint32_t(component.children.size()));
+    for (const Entity &child : component.children)
+        writer.writeEntity(child);
+}
 
+void deserialize(SnapshotReader &reader, Transform &component)
+{
+    component.transform.setPosition(reader.read<sf::Vector2f>());
+    component.transform.setRotation(sf::degrees(reader.read<float>()));
+    component.transform.setScale(reader.read<sf::Vector2f>());
+    component.transform.setOrigin(reader.read<sf::Vector2f>());
+    component.local_position = reader.read<sf::Vector2f>();
+
+    component.parent = reader.readEntity();
+    component.children.resize(reader.read<uint32_t>());
+    for (Entity &child : component.children)
+        child = reader.readEntity();
+}
+
+// VELOCITY
+void VelocityComponentFactory::init(toml::table &component_table)
+{
     if (component_table.contains("max_velocity"))
         component.max_velocity
             = vector2::tomlArrayToVector2f(component_table.at("max_velocity").as_array());
 }
 
-// SCENE
-void SceneComponentFactory::create(Entity &entity)
+void VelocityComponentFactory::create(Entity &entity)
 {
-    auto &component = entity.add<Scene>();
+    entity.add<Velocity>(component);
+}
+
+void serialize(SnapshotWriter &writer, const Velocity &component)
+{
+    writer.write(component.velocity);
+    writer.write(component.max_velocity);
+}
 
+void deserialize(SnapshotReader &reader, Velocity &component)
+{
+    component.velocity = reader.read<sf::Vector2f>();
+    component.max_velocity = reader.read<sf::Vector2f>();
+}
+
+// SCENE
+void SceneComponentFactory::init(toml::table &component_table)
+{
     if (component_table.contains("local_bounds"))
         component.local_bounds
             = rect::tomlArrayToFloatRect(component_table.at("local_bounds").as_array());
@@ -50,17 +94,46 @@ void SceneComponentFactory::create(Entity &entity)
         component.path_finder_wall = component_table.at("path_finder_wall").as_boolean()->get();
 }
 
+void SceneComponentFactory::create(Entity &entity)
+{
+    entity.add<Scene>(component);
+}
+
+void serialize(SnapshotWriter &writer, const Scene &component)
+{
+    writer.write(component.local_bounds);
+    writer.write(component.global_bounds);
+    writer.write(component.path_finder_wall);
+}
+
+void deserialize(SnapshotReader &reader, Scene &component)
+{
+    component.local_bounds = reader.read<sf::FloatRect>();
+    component.global_bounds = reader.read<sf::FloatRect>();
+    component.path_finder_wall = reader.read<bool>();
+}
+
 // PLAYER
 void PlayerComponentFactory::create(Entity &entity)
 {
-    auto &component = entity.add<Player>();
+    entity.add<Player>();
 }
 
-// DRAWABLE
-void DrawableComponentFactory::create(Entity &entity)
+void serialize(SnapshotWriter &writer, const Player &component)
 {
-    auto &drawable_component = entity.add<Drawable>();
+    writer.write(component.need_change_target);
+    writer.write(component.view_hard_set_position);
+}
 
+void deserialize(SnapshotReader &reader, Player &component)
+{
+    component.need_change_target = reader.read<bool>();
+    component.view_hard_set_position = reader.read<bool>();
+}
+
+// DRAWABLE
+void DrawableComponentFactory::init(toml::table &component_table)
+{
     for (const auto &it : component_table)
     {
         if (it.second.is_table())
@@ -71,41 +144,43 @@ void DrawableComponentFactory::create(Entity &entity)
                 toml::table *shadow_table = it.second.as_table();
                 std::string type = shadow_table->at("type").as_string()->get();
 
+                sf::Shape *shape = nullptr;
                 if (type == "rect")
                 {
-                    sf::RectangleShape *shape = new sf::RectangleShape();
-                    shape->setFillColor(sf::Color(0, 0, 0, 110));
-
-                    shape->setSize(
+                    rect_shadow_shape.emplace();
+                    rect_shadow_shape->setSize(
                         vector2::tomlArrayToVector2f(shadow_table->at("rect_size").as_array()));
-
-                    drawable_component.shadow_shape.reset(shape);
+                    shape = &rect_shadow_shape.value();
                 }
                 else if (type == "circle")
                 {
-                    sf::CircleShape *shape = new sf::CircleShape();
-                    shape->setFillColor(sf::Color(0, 0, 0, 110));
-
-                    shape->setPointCount(12);
-                    shape->setRadius(shadow_table->at("radius").as_floating_point()->get());
-
-                    drawable_component.shadow_shape.reset(shape);
+                    circle_shadow_shape.emplace();
+                    circle_shadow_shape->setPointCount(12);
+                    circle_shadow_shape->setRadius(
+                        shadow_table->at("radius").as_floating_point()->get());
+                    shape = &circle_shadow_shape.value();
                 }
+                else
+                {
+                    throw Exception(fmt::format("Unknown shadow type: {}", type));
+                }
+
+                shape->setFillColor(sf::Color(0, 0, 0, 110));
 
                 if (shadow_table->contains("position"))
-                    drawable_component.shadow_shape->setPosition(
+                    shape->setPosition(
                         vector2::tomlArrayToVector2f(shadow_table->at("position").as_array()));
 
                 if (shadow_table->contains("rotation"))
-                    drawable_component.shadow_shape->setRotation(
+                    shape->setRotation(
                         sf::degrees(shadow_table->at("rotation").as_floating_point()->get()));
 
                 if (shadow_table->contains("scale"))
-                    drawable_component.shadow_shape->setScale(
+                    shape->setScale(
                         vector2::tomlArrayToVector2f(shadow_table->at("scale").as_array()));
 
                 if (shadow_table->contains("origin"))
-                    drawable_component.shadow_shape->setOrigin(
+                    shape->setOrigin(
                         vector2::tomlArrayToVector2f(shadow_table->at("origin").as_array()));
             }
             else
@@ -114,19 +189,9 @@ void DrawableComponentFactory::create(Entity &entity)
                     = DrawableFactory::createDrawable(
                         drawable_type::fromString(it.first.data()), it.second.as_table());
 
-                drawable_component.proxy.reset(drawable_proxy);
-
-                if (drawable_state)
-                {
-                    auto &drawable_state_component = entity.add<DrawableState>();
-                    drawable_state_component.state.reset(drawable_state);
-                }
-
-                if (drawable_animation)
-                {
-                    auto &drawable_animation_component = entity.add<DrawableAnimation>();
-                    drawable_animation_component.animation.reset(drawable_animation);
-                }
+                proxy.reset(drawable_proxy);
+                state.reset(drawable_state);
+                animation.reset(drawable_animation);
             }
         }
         else
@@ -134,28 +199,136 @@ void DrawableComponentFactory::create(Entity &entity)
             std::string field_name = it.first.data();
 
             if (field_name == "z_order")
-                drawable_component.z_order = it.second.as_integer()->get();
+                z_order = it.second.as_integer()->get();
 
             if (field_name == "z_order_fill_y_coordinate")
-                drawable_component.z_order_fill_y_coordinate = it.second.as_boolean()->get();
+                z_order_fill_y_coordinate = it.second.as_boolean()->get();
         }
     }
 }
 
-// COLLISION
-void CollisionComponentFactory::create(Entity &entity)
+void DrawableComponentFactory::create(Entity &entity)
+{
+    createDrawable(entity, entity.add<Drawable>());
+}
+
+void DrawableComponentFactory::createDrawable(Entity &entity, Drawable &drawable_component) const
 {
-    auto &component = entity.add<Collision>();
+    drawable_component.prefab_name = prefab_name;
+    drawable_component.z_order = z_order;
+    drawable_component.z_order_fill_y_coordinate = z_order_fill_y_coordinate;
+
+    if (rect_shadow_shape)
+        drawable_component.shadow_shape = std::make_unique<sf::RectangleShape>(*rect_shadow_shape);
+    else if (circle_shadow_shape)
+        drawable_component.shadow_shape = std::make_unique<sf::CircleShape>(*circle_shadow_shape);
+
+    if (!proxy)
+        return;
+
+    drawable_component.proxy.reset(proxy->copy());
+
+    if (state)
+    {
+        auto &drawable_state_component = entity.add<DrawableState>();
+        drawable_state_component.state.reset(state->copy(drawable_component.proxy.get()));
+    }
+
+    if (animation)
+    {
+        auto &drawable_animation_component = entity.add<DrawableAnimation>();
+        drawable_animation_component.animation.reset(
+            animation->copy(drawable_component.proxy.get()));
+    }
+}
+
+void serialize(SnapshotWriter &writer, const Drawable &component)
+{
+    writer.write(component.z_order);
+    writer.write(component.z_order_fill_y_coordinate);
+    writer.writeString(component.prefab_name);
+
+    // Tiles of tile map are written, they can be changed after map creation
+    const TileMap *tile_map = !component.tile_map_texture_name.empty() && component.proxy
+                                  ? static_cast<const TileMap *>(component.proxy->data())
+                                  : nullptr;
+
+    writer.writeString(tile_map ? component.tile_map_texture_name : std::string{});
+    if (!tile_map)
+        return;
+
+    const Vector2D<int32_t> &tiles = tile_map->getTiles();
+    writer.write(tile_map->getTileSize());
+    writer.write(tiles.getSize2D());
+    for (std::size_t i = 0; i < tiles.getSize(); ++i)
+        writer.write(tiles[i]);
+}
+
+void deserialize(SnapshotReader &reader, Drawable &component)
+{
+    int32_t z_order = reader.read<int32_t>();
+    bool z_order_fill_y_coordinate = reader.read<bool>();
+    std::string prefab_name = reader.readString();
+    std::string tile_map_texture_name = reader.readString();
+
+    if (!prefab_name.empty())
+    {
+        auto drawable_factory = static_cast<const DrawableComponentFactory *>(
+            EntityFactory::findComponentFactory(prefab_name, component_type::DRAWABLE));
+
+        Entity entity = reader.getEntity();
+        if (drawable_factory)
+            drawable_factory->createDrawable(entity, component);
+        else
+            spdlog::warn("Drawable of entity not found: {}", prefab_name);
+    }
+
+    if (!tile_map_texture_name.empty())
+    {
+        sf::Vector2i tile_size = reader.read<sf::Vector2i>();
+        Vector2D<int32_t> tiles;
+        tiles.resize(reader.read<sf::Vector2i>());
+        for (std::size_t i = 0; i < tiles.getSize(); ++i)
+            tiles[i] = reader.read<int32_t>();
+
+        component.tile_map_texture_name = tile_map_texture_name;
+
+        sf::Texture *texture = ResourceCache::get<sf::Texture>(tile_map_texture_name);
+        if (texture)
+            component.proxy.reset(new DrawableProxy(new TileMap{*texture, tile_size, tiles}));
+        else
+            spdlog::warn("Tile map texture not found: {}", tile_map_texture_name);
+    }
+
+    component.z_order = z_order;
+    component.z_order_fill_y_coordinate = z_order_fill_y_coordinate;
+}
 
+// COLLISION
+void CollisionComponentFactory::init(toml::table &component_table)
+{
     if (component_table.contains("wall"))
         component.wall = component_table.at("wall").as_boolean()->get();
 }
 
-// STATE
-void StateComponentFactory::create(Entity &entity)
+void CollisionComponentFactory::create(Entity &entity)
 {
-    auto &component = entity.add<State>();
+    entity.add<Collision>(component);
+}
 
+void serialize(SnapshotWriter &writer, const Collision &component)
+{
+    writer.write(component.wall);
+}
+
+void deserialize(SnapshotReader &reader, Collision &component)
+{
+    component.wall = reader.read<bool>();
+}
+
+// STATE
+void StateComponentFactory::init(toml::table &component_table)
+{
     if (component_table.contains("state"))
         component.state
             = entity_state::stateFromString(component_table.at("state").as_string()->get());
@@ -165,21 +338,53 @@ void StateComponentFactory::create(Entity &entity)
             = entity_state::directionFromString(component_table.at("direction").as_string()->get());
 }
 
+void StateComponentFactory::create(Entity &entity)
+{
+    entity.add<State>(component);
+}
+
+void serialize(SnapshotWriter &writer, const State &component)
+{
+    writer.write(component.state);
+    writer.write(component.direction);
+}
+
+void deserialize(SnapshotReader &reader, State &component)
+{
+    component.state = reader.read<entity_state::State>();
+    component.direction = reader.read<entity_state::Direction>();
+}
+
 // SOUND
 void SoundComponentFactory::create(Entity &entity)
 {
-    auto &component = entity.add<Sound>();
+    entity.add<Sound>();
+}
+
+void serialize(SnapshotWriter &writer, const Sound &component)
+{
+    writer.write(component.tile_material);
+}
+
+void deserialize(SnapshotReader &reader, Sound &component)
+{
+    component.tile_material = reader.read<tile_material_type::Type>();
 }
 
 // SCRIPT
+void ScriptComponentFactory::init(toml::table &component_table)
+{
+    if (component_table.contains("script"))
+        script_name = component_table.at("script").as_string()->get();
+}
+
 void ScriptComponentFactory::create(Entity &entity)
 {
     auto &component = entity.add<Script>();
+    component.script_name = script_name;
 
-    if (component_table.contains("script"))
+    if (!script_name.empty())
     {
-        std::string script_name = component_table.at("script").as_string()->get();
-
         script::Script *script = ScriptFactory::createScript(script_name);
         if (!script)
         {
@@ -192,26 +397,82 @@ void ScriptComponentFactory::create(Entity &entity)
     }
 }
 
+void serialize(SnapshotWriter &writer, const Script &component)
+{
+    writer.writeString(component.script_name);
+}
+
+void deserialize(SnapshotReader &reader, Script &component)
+{
+    component.script_name = reader.readString();
+    if (component.script_name.empty())
+        return;
+
+    component.script.reset(ScriptFactory::createScript(component.script_name));
+    if (!component.script)
+    {
+        spdlog::warn("Script not found: {}", component.script_name);
+        return;
+    }
+
+    component.script->setEntityToTable(reader.getEntity());
+}
+
 // TARGET
 void TargetComponentFactory::create(Entity &entity)
 {
-    auto &component = entity.add<Target>();
+    entity.add<Target>();
 }
 
-// TARGET_FOLLOW
-void TargetFollowComponentFactory::create(Entity &entity)
+void serialize(SnapshotWriter &writer, const Target &component)
+{
+    writer.writeEntity(component.target);
+    writer.write(uint32_t(component.lookings.size()));
+    for (const Entity &looking : component.lookings)
+        writer.writeEntity(looking);
+}
+
+void deserialize(SnapshotReader &reader, Target &component)
 {
-    auto &component = entity.add<TargetFollow>();
+    component.target = reader.readEntity();
+    component.lookings.resize(reader.read<uint32_t>());
+    for (Entity &looking : component.lookings)
+        looking = reader.readEntity();
+}
 
+// TARGET_FOLLOW
+void TargetFollowComponentFactory::init(toml::table &component_table)
+{
     if (component_table.contains("min_distance"))
         component.min_distance = component_table.at("min_distance").as_floating_point()->get();
 }
 
-// LOOK_AROUND
-void LookAroundComponentFactory::create(Entity &entity)
+void TargetFollowComponentFactory::create(Entity &entity)
 {
-    auto &component = entity.add<LookAround>();
+    entity.add<TargetFollow>(component);
+}
 
+void serialize(SnapshotWriter &writer, const TargetFollow &component)
+{
+    writer.write(component.follow);
+    writer.write(component.min_distance);
+    writer.write(component.state);
+    writer.writeVector(component.path);
+    writer.write(component.target);
+}
+
+void deserialize(SnapshotReader &reader, TargetFollow &component)
+{
+    component.follow = reader.read<bool>();
+    component.min_distance = reader.read<float>();
+    component.state = reader.read<TargetFollow::State>();
+    component.path = reader.readVector<sf::Vector2i>();
+    component.target = reader.read<sf::Vector2f>();
+}
+
+// LOOK_AROUND
+void LookAroundComponentFactory::init(toml::table &component_table)
+{
     if (component_table.contains("enable"))
         component.enable = component_table.at("enable").as_boolean()->get();
 
@@ -219,11 +480,27 @@ void LookAroundComponentFactory::create(Entity &entity)
         component.distance = component_table.at("distance").as_floating_point()->get();
 }
 
-// STATS
-void StatsComponentFactory::create(Entity &entity)
+void LookAroundComponentFactory::create(Entity &entity)
 {
-    auto &component = entity.add<Stats>();
+    entity.add<LookAround>(component);
+}
 
+// Found entities are looked up again by LookAround system
+void serialize(SnapshotWriter &writer, const LookAround &component)
+{
+    writer.write(component.enable);
+    writer.write(component.distance);
+}
+
+void deserialize(SnapshotReader &reader, LookAround &component)
+{
+    component.enable = reader.read<bool>();
+    component.distance = reader.read<float>();
+}
+
+// STATS
+void StatsComponentFactory::init(toml::table &component_table)
+{
     if (component_table.contains("health"))
         component.health = component_table.at("health").as_floating_point()->get();
 
@@ -235,18 +512,48 @@ void StatsComponentFactory::create(Entity &entity)
 
     if (component_table.contains("max_armor"))
         component.max_armor = component_table.at("max_armor").as_floating_point()->get();
+}
 
+void StatsComponentFactory::create(Entity &entity)
+{
+    entity.add<Stats>(component);
     entity.add<Damage>();
 }
 
-// SKILLS
-void SkillsComponentFactory::create(Entity &entity)
+void serialize(SnapshotWriter &writer, const Stats &component)
 {
-    auto &component = entity.add<Skills>();
+    writer.write(component.health);
+    writer.write(component.max_health);
+    writer.write(component.armor);
+    writer.write(component.max_armor);
+    writer.write(component.damage);
+    writer.write(component.death_time);
+    writer.write(component.disappearance_time);
+    writer.write(component.death_elipsed);
+}
 
-    std::vector<std::string> skills;
+void deserialize(SnapshotReader &reader, Stats &component)
+{
+    component.health = reader.read<float>();
+    component.max_health = reader.read<float>();
+    component.armor = reader.read<float>();
+    component.max_armor = reader.read<float>();
+    component.damage = reader.read<float>();
+    component.death_time = reader.read<double>();
+    component.disappearance_time = reader.read<double>();
+    component.death_elipsed = reader.read<double>();
+}
+
+// SKILLS
+void SkillsComponentFactory::init(toml::table &component_table)
+{
     if (component_table.contains("skills"))
         skills = vector::tomlArrayToStringVector(component_table.at("skills").as_array());
+}
+
+void SkillsComponentFactory::create(Entity &entity)
+{
+    auto &component = entity.add<Skills>();
 
     for (const std::string &skill_name : skills)
     {
@@ -262,10 +569,61 @@ void SkillsComponentFactory::create(Entity &entity)
     }
 }
 
+void serialize(SnapshotWriter &writer, const Skills &component)
+{
+    writer.write(component.next_skill);
+    writer.write(uint32_t(component.skills.size()));
+    for (const auto &skill : component.skills)
+        writer.writeString(skill->getSkillFactory()->getSkillName());
+}
+
+void deserialize(SnapshotReader &reader, Skills &component)
+{
+    component.next_skill = reader.read<int32_t>();
+
+    uint32_t skills_count = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < skills_count; ++i)
+    {
+        std::string skill_name = reader.readString();
+        skill::Skill *skill = SkillFactory::createSkill(skill_name);
+        if (!skill)
+        {
+            spdlog::warn("Skill not found: {}", skill_name);
+            continue;
+        }
+
+        skill->setEntityToTable(reader.getEntity());
+        component.skills.push_back(std::unique_ptr<skill::Skill>(skill));
+    }
+
+    if (component.next_skill >= int32_t(component.skills.size()))
+        component.next_skill = -1;
+}
+
+// DAMAGE
+// Damage in progress is not saved, only presence of component
+void serialize([[maybe_unused]] SnapshotWriter &writer, [[maybe_unused]] const Damage &component)
+{
+}
+
+void deserialize([[maybe_unused]] SnapshotReader &reader, [[maybe_unused]] Damage &component)
+{
+}
+
 // MARKER
 void MarkerComponentFactory::create(Entity &entity)
 {
-    auto &component = entity.add<Marker>();
+    entity.add<Marker>();
+}
+
+void serialize(SnapshotWriter &writer, const Marker &component)
+{
+    writer.writeEntity(component.marker);
+}
+
+void deserialize(SnapshotReader &reader, Marker &component)
+{
+    component.marker = reader.readEntity();
 }
 
 } // namespace fck::component
@@ -7,6 +7,7 @@
 #include "../fck/drawable_proxy.h"
 #include "../fck/drawable_state.h"
 #include "../fck/entity.h"
+#include "../fck/snapshot.h"
 #include "../fck_common.h"
 #include "../knowledge_base/entity_factory.h"
 #include "../knowledge_base/knowledge_base.h"
@@ -17,6 +18,7 @@
 #include <SFML/Graphics.hpp>
 
 #include <list>
+#include <optional>
 
 namespace fck::component
 {
@@ -24,7 +26,10 @@ namespace fck::component
 // TRANSFORM
 struct Transform
 {
+    // World transform, for child entities it follows parent position
     sf::Transformable transform;
+    // Offset from parent position
+    sf::Vector2f local_position;
 
     Entity parent;
     std::vector<Entity> children;
@@ -32,10 +37,17 @@ struct Transform
 
 struct TransformComponentFactory : public ComponentFactory::Factory
 {
+    void init(toml::table &component_table);
     void create(Entity &entity);
+
+    Transform component;
 };
 REGISTER_COMPONENT_FACTORY(component_type::TRANSFORM, TransformComponentFactory);
 
+void serialize(SnapshotWriter &writer, const Transform &component);
+void deserialize(SnapshotReader &reader, Transform &component);
+REGISTER_COMPONENT_SERIALIZER(component_type::toString(component_type::TRANSFORM), Transform);
+
 // VELOCITY
 struct Velocity
 {
@@ -45,10 +57,17 @@ struct Velocity
 
 struct VelocityComponentFactory : public ComponentFactory::Factory
 {
+    void init(toml::table &component_table);
     void create(Entity &entity);
+
+    Velocity component;
 };
 REGISTER_COMPONENT_FACTORY(component_type::VELOCITY, VelocityComponentFactory);
 
+void serialize(SnapshotWriter &writer, const Velocity &component);
+void deserialize(SnapshotReader &reader, Velocity &component);
+REGISTER_COMPONENT_SERIALIZER(component_type::toString(component_type::VELOCITY), Velocity);
+
 // SCENE
 struct Scene
 {
@@ -65,10 +84,17 @@ struct Scene
 
 struct SceneComponentFactory : public ComponentFactory::Factory
 {
+    void init(toml::table &component_table);
     void create(Entity &entity);
+
+    Scene component;
 };
 REGISTER_COMPONENT_FACTORY(component_type::SCENE, SceneComponentFactory);
 
+void serialize(SnapshotWriter &writer, const Scene &component);
+void deserialize(SnapshotReader &reader, Scene &component);
+REGISTER_COMPONENT_SERIALIZER(component_type::toString(component_type::SCENE), Scene);
+
 // PLAYER
 struct Player
 {
@@ -82,6 +108,10 @@ struct PlayerComponentFactory : public ComponentFactory::Factory
 };
 REGISTER_COMPONENT_FACTORY(component_type::PLAYER, PlayerComponentFactory);
 
+void serialize(SnapshotWriter &writer, const Player &component);
+void deserialize(SnapshotReader &reader, Player &component);
+REGISTER_COMPONENT_SERIALIZER(component_type::toString(component_type::PLAYER), Player);
+
 // DRAWABLE
 struct Drawable
 {
@@ -95,15 +125,40 @@ struct Drawable
     b2::DynamicTree<Entity> *tree = nullptr;
 
     std::unique_ptr<sf::Shape> shadow_shape;
+
+    // Drawable is rebuilt by them when world is restored: entity prefab it's created by, or
+    // texture of tile map created by map factory
+    std::string prefab_name;
+    std::string tile_map_texture_name;
 };
 
 struct DrawableComponentFactory : public ComponentFactory::Factory
 {
+    void init(toml::table &component_table);
     void create(Entity &entity);
+    // Adds drawable state and animation components too
+    void createDrawable(Entity &entity, Drawable &drawable_component) const;
+
+    std::string prefab_name;
+
+    std::unique_ptr<DrawableProxyBase> proxy;
+    std::unique_ptr<fck::DrawableState> state;
+    std::unique_ptr<fck::DrawableAnimation> animation;
+
+    int32_t z_order = 0;
+    bool z_order_fill_y_coordinate = true;
+
+    std::optional<sf::RectangleShape> rect_shadow_shape;
+    std::optional<sf::CircleShape> circle_shadow_shape;
 };
 REGISTER_COMPONENT_FACTORY(component_type::DRAWABLE, DrawableComponentFactory);
 
+void serialize(SnapshotWriter &writer, const Drawable &component);
+void deserialize(SnapshotReader &reader, Drawable &component);
+REGISTER_COMPONENT_SERIALIZER(component_type::toString(component_type::DRAWABLE), Drawable);
+
 // DRAWABLE_STATE
+// State and animation aren't serialized, they are rebuilt with drawable of entity prefab
 struct DrawableState
 {
     std::unique_ptr<fck::DrawableState> state;
@@ -123,10 +178,17 @@ struct Collision
 
 struct CollisionComponentFactory : public ComponentFactory::Factory
 {
+    void init(toml::table &component_table);
     void create(Entity &entity);
+
+    Collision component;
 };
 REGISTER_COMPONENT_FACTORY(component_type::COLLISION, CollisionComponentFactory);
 
+void serialize(SnapshotWriter &writer, const Collision &component);
+void deserialize(SnapshotReader &reader, Collision &component);
+REGISTER_COMPONENT_SERIALIZER(component_type::toString(component_type::COLLISION), Collision);
+
 // STATE
 struct State
 {
@@ -136,10 +198,17 @@ struct State
 
 struct StateComponentFactory : public ComponentFactory::Factory
 {
+    void init(toml::table &component_table);
     void create(Entity &entity);
+
+    State component;
 };
 REGISTER_COMPONENT_FACTORY(component_type::STATE, StateComponentFactory);
 
+void serialize(SnapshotWriter &writer, const State &component);
+void deserialize(SnapshotReader &reader, State &component);
+REGISTER_COMPONENT_SERIALIZER(component_type::toString(component_type::STATE), State);
+
 // SOUND
 struct Sound
 {
@@ -159,19 +228,34 @@ struct SoundComponentFactory : public ComponentFactory::Factory
 };
 REGISTER_COMPONENT_FACTORY(component_type::SOUND, SoundComponentFactory);
 
+// Sound groups are filled by scripts and aren't saved
+void serialize(SnapshotWriter &writer, const Sound &component);
+void deserialize(SnapshotReader &reader, Sound &component);
+REGISTER_COMPONENT_SERIALIZER(component_type::toString(component_type::SOUND), Sound);
+
 // SCRIPT
 struct Script
 {
     //    std::unique_ptr<EntityScriptBase> entity_script;
     std::unique_ptr<script::Script> script;
+    // Name in ScriptFactory
+    std::string script_name;
 };
 
 struct ScriptComponentFactory : public ComponentFactory::Factory
 {
+    void init(toml::table &component_table);
     void create(Entity &entity);
+
+    std::string script_name;
 };
 REGISTER_COMPONENT_FACTORY(component_type::SCRIPT, ScriptComponentFactory);
 
+// Script is created anew by its name, values of its table aren't saved
+void serialize(SnapshotWriter &writer, const Script &component);
+void deserialize(SnapshotReader &reader, Script &component);
+REGISTER_COMPONENT_SERIALIZER(component_type::toString(component_type::SCRIPT), Script);
+
 // TARGET
 struct Target
 {
@@ -185,6 +269,10 @@ struct TargetComponentFactory : public ComponentFactory::Factory
 };
 REGISTER_COMPONENT_FACTORY(component_type::TARGET, TargetComponentFactory);
 
+void serialize(SnapshotWriter &writer, const Target &component);
+void deserialize(SnapshotReader &reader, Target &component);
+REGISTER_COMPONENT_SERIALIZER(component_type::toString(component_type::TARGET), Target);
+
 // TARGET_FOLLOW
 struct TargetFollow
 {
@@ -203,10 +291,18 @@ struct TargetFollow
 
 struct TargetFollowComponentFactory : public ComponentFactory::Factory
 {
+    void init(toml::table &component_table);
     void create(Entity &entity);
+
+    TargetFollow component;
 };
 REGISTER_COMPONENT_FACTORY(component_type::TARGET_FOLLOW, TargetFollowComponentFactory);
 
+void serialize(SnapshotWriter &writer, const TargetFollow &component);
+void deserialize(SnapshotReader &reader, TargetFollow &component);
+REGISTER_COMPONENT_SERIALIZER(
+    component_type::toString(component_type::TARGET_FOLLOW), TargetFollow);
+
 // LOOK_AROUND
 struct LookAround
 {
@@ -222,10 +318,17 @@ struct LookAround
 
 struct LookAroundComponentFactory : public ComponentFactory::Factory
 {
+    void init(toml::table &component_table);
     void create(Entity &entity);
+
+    LookAround component;
 };
 REGISTER_COMPONENT_FACTORY(component_type::LOOK_AROUND, LookAroundComponentFactory);
 
+void serialize(SnapshotWriter &writer, const LookAround &component);
+void deserialize(SnapshotReader &reader, LookAround &component);
+REGISTER_COMPONENT_SERIALIZER(component_type::toString(component_type::LOOK_AROUND), LookAround);
+
 // STATS
 struct Stats
 {
@@ -244,10 +347,17 @@ struct Stats
 
 struct StatsComponentFactory : public ComponentFactory::Factory
 {
+    void init(toml::table &component_table);
     void create(Entity &entity);
+
+    Stats component;
 };
 REGISTER_COMPONENT_FACTORY(component_type::STATS, StatsComponentFactory);
 
+void serialize(SnapshotWriter &writer, const Stats &component);
+void deserialize(SnapshotReader &reader, Stats &component);
+REGISTER_COMPONENT_SERIALIZER(component_type::toString(component_type::STATS), Stats);
+
 // SKILLS
 struct Skills
 {
@@ -257,16 +367,28 @@ struct Skills
 
 struct SkillsComponentFactory : public ComponentFactory::Factory
 {
+    void init(toml::table &component_table);
     void create(Entity &entity);
+
+    std::vector<std::string> skills;
 };
 REGISTER_COMPONENT_FACTORY(component_type::SKILLS, SkillsComponentFactory);
 
+// Skills are created anew by their names and are ready after restore
+void serialize(SnapshotWriter &writer, const Skills &component);
+void deserialize(SnapshotReader &reader, Skills &component);
+REGISTER_COMPONENT_SERIALIZER(component_type::toString(component_type::SKILLS), Skills);
+
 // DAMAGE
 struct Damage
 {
     std::unique_ptr<DamageBase> damage;
 };
 
+void serialize(SnapshotWriter &writer, const Damage &component);
+void deserialize(SnapshotReader &reader, Damage &component);
+REGISTER_COMPONENT_SERIALIZER(component_type::toString(component_type::DAMAGE), Damage);
+
 // MARKER
 struct Marker
 {
@@ -279,6 +401,10 @@ struct MarkerComponentFactory : public ComponentFactory::Factory
 };
 REGISTER_COMPONENT_FACTORY(component_type::MARKER, MarkerComponentFactory);
 
+void serialize(SnapshotWriter &writer, const Marker &component);
+void deserialize(SnapshotReader &reader, Marker &component);
+REGISTER_COMPONENT_SERIALIZER(component_type::toString(component_type::MARKER), Marker);
+
 } // namespace fck::component
 
 #endif // COMPONENTS_QCNBORXCAKAM_H
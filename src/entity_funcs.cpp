@@ -6,22 +6,25 @@ namespace fck
 {
 
 // signals
-sigslot::signal<const Entity &, const sf::Vector2f &> entity_funcs::moved;
-sigslot::signal<const Entity &, const Entity &> entity_funcs::parent_changed;
-sigslot::signal<const Entity &, entity_state::State> entity_funcs::state_changed;
-sigslot::signal<const Entity &, entity_state::Direction> entity_funcs::direction_changed;
-sigslot::signal<const Entity &, const Entity &> entity_funcs::collided;
+InlineSignal<const std::vector<entity_funcs::Moved> &> entity_funcs::moved;
+InlineSignal<const Entity &, const Entity &> entity_funcs::parent_changed;
+InlineSignal<const Entity &, entity_state::State> entity_funcs::state_changed;
+InlineSignal<const Entity &, entity_state::Direction> entity_funcs::direction_changed;
+InlineSignal<const Entity &, const Entity &> entity_funcs::collided;
 sigslot::signal<const Entity &, const Entity &, const Entity &> entity_funcs::target_changed;
-sigslot::signal<const Entity &, const Entity &> entity_funcs::marker_changed;
-sigslot::signal<const Entity &, const std::string &> entity_funcs::drawable_state_changed;
+InlineSignal<const Entity &, const Entity &> entity_funcs::marker_changed;
+InlineSignal<const Entity &, const std::string &> entity_funcs::drawable_state_changed;
 sigslot::signal<const Entity &, float> entity_funcs::health_changed;
 sigslot::signal<const Entity &, float> entity_funcs::armor_changed;
-sigslot::signal<const Entity &, const std::string &> entity_funcs::sound_playing;
-sigslot::signal<const Entity &, const std::string &> entity_funcs::sound_stopped;
-sigslot::signal<const Entity &> entity_funcs::all_sound_stopped;
+InlineSignal<const Entity &, const std::string &> entity_funcs::sound_playing;
+InlineSignal<const Entity &, const std::string &> entity_funcs::sound_stopped;
+InlineSignal<const Entity &> entity_funcs::all_sound_stopped;
 sigslot::signal<const Entity &, skill::Skill *> entity_funcs::skill_applied;
 sigslot::signal<const Entity &, skill::Skill *> entity_funcs::skill_finished;
 
+std::vector<entity_funcs::Moved> entity_funcs::m_moved;
+std::vector<int32_t> entity_funcs::m_moved_positions;
+
 // funcs
 // transform
 void entity_funcs::move(const Entity &entity, const sf::Vector2f &offset)
@@ -29,25 +32,13 @@ void entity_funcs::move(const Entity &entity, const sf::Vector2f &offset)
     auto &transform_component = entity.get<component::Transform>();
     transform_component.transform.move(offset);
 
-    if (!transform_component.children.empty())
-    {
-        for (auto it = transform_component.children.begin();
-             it != transform_component.children.end();)
-        {
-            if (it->isValid())
-            {
-                auto &child_transform_component = it->get<component::Transform>();
-                setPosition(*it, transform_component.transform.getPosition());
-                ++it;
-            }
-            else
-            {
-                it = transform_component.children.erase(it);
-            }
-        }
-    }
+    // Children follow in TransformHierarchy update, they see Transform changed
+    if (transform_component.parent.isValid())
+        transform_component.local_position += offset;
 
-    moved(entity, offset);
+    entity.markChanged<component::Transform>();
+
+    markMoved(entity, offset);
 }
 
 void entity_funcs::setPosition(const Entity &entity, const sf::Vector2f &position)
@@ -84,9 +75,59 @@ void entity_funcs::setParent(const Entity &entity, const Entity &parent)
         setPosition(entity, parent_transform_component.transform.getPosition());
     }
 
+    transform_component.local_position = {};
+
     parent_changed(entity, parent);
 }
 
+void entity_funcs::markMoved(const Entity &entity, const sf::Vector2f &offset)
+{
+    uint32_t index = entity.getId().getIndex();
+    if (m_moved_positions.size() <= index)
+        m_moved_positions.resize(index + 1, -1);
+
+    int32_t position = m_moved_positions[index];
+    if (position != -1 && m_moved[position].entity == entity)
+    {
+        m_moved[position].offset += offset;
+        return;
+    }
+
+    m_moved_positions[index] = m_moved.size();
+    m_moved.push_back({entity, offset});
+}
+
+void entity_funcs::flushMoved()
+{
+    if (m_moved.empty())
+        return;
+
+    // Slots may move entities again, those moves go to next flush
+    std::vector<Moved> moved_entities;
+    moved_entities.swap(m_moved);
+
+    for (const Moved &it : moved_entities)
+        m_moved_positions[it.entity.getId().getIndex()] = -1;
+
+    // Entities could be destroyed after they were moved
+    moved_entities.erase(
+        std::remove_if(
+            moved_entities.begin(),
+            moved_entities.end(),
+            [](const Moved &it) { return !it.entity.isValid(); }),
+        moved_entities.end());
+
+    if (!moved_entities.empty())
+        moved(moved_entities);
+
+    // Keep capacity for next tick
+    if (m_moved.empty())
+    {
+        moved_entities.clear();
+        m_moved.swap(moved_entities);
+    }
+}
+
 void entity_funcs::setState(const Entity &entity, entity_state::State state)
 {
     auto &state_component = entity.get<component::State>();
@@ -94,7 +135,8 @@ void entity_funcs::setState(const Entity &entity, entity_state::State state)
     if (state_component.state != state)
     {
         state_component.state = state;
-        state_changed(entity, state);
+        entity.markChanged<component::State>();
+        emit(state_changed, entity, state);
     }
 }
 
@@ -105,7 +147,8 @@ void entity_funcs::setDirection(const Entity &entity, entity_state::Direction di
     if (state_component.direction != direction)
     {
         state_component.direction = direction;
-        direction_changed(entity, direction);
+        entity.markChanged<component::State>();
+        emit(direction_changed, entity, direction);
     }
 }
 
@@ -170,7 +213,7 @@ void entity_funcs::setDrawableState(const Entity &entity, const std::string &sta
         if (drawable_state_component.state)
         {
             drawable_state_component.state->setCurrentState(state);
-            drawable_state_changed(entity, state);
+            emit(drawable_state_changed, entity, state);
         }
     }
     else if (entity.has<component::DrawableAnimation>())
@@ -180,24 +223,24 @@ void entity_funcs::setDrawableState(const Entity &entity, const std::string &sta
         {
             drawable_animation_component.animation->setCurrentState(state);
             drawable_animation_component.animation->start();
-            drawable_state_changed(entity, state);
+            emit(drawable_state_changed, entity, state);
         }
     }
 }
 
 void entity_funcs::playSound(const Entity &entity, const std::string &sound_name)
 {
-    sound_playing(entity, sound_name);
+    emit(sound_playing, entity, sound_name);
 }
 
 void entity_funcs::stopSound(const Entity &entity, const std::string &sound_name)
 {
-    sound_stopped(entity, sound_name);
+    emit(sound_stopped, entity, sound_name);
 }
 
 void entity_funcs::stopAllSound(const Entity &entity)
 {
-    all_sound_stopped(entity);
+    emit(all_sound_stopped, entity);
 }
 
 void entity_funcs::setScript(const Entity &entity, const std::string &script_name)
@@ -215,7 +258,30 @@ void entity_funcs::setScript(const Entity &entity, const std::string &script_nam
     }
 
     script_component.script.reset(script);
+    script_component.script_name = script_name;
     script_component.script->setEntityToTable(entity);
 }
 
+void entity_funcs::reset()
+{
+    moved.disconnectAll();
+    parent_changed.disconnectAll();
+    state_changed.disconnectAll();
+    direction_changed.disconnectAll();
+    collided.disconnectAll();
+    target_changed.disconnect_all();
+    marker_changed.disconnectAll();
+    drawable_state_changed.disconnectAll();
+    health_changed.disconnect_all();
+    armor_changed.disconnect_all();
+    sound_playing.disconnectAll();
+    sound_stopped.disconnectAll();
+    all_sound_stopped.disconnectAll();
+    skill_applied.disconnect_all();
+    skill_finished.disconnect_all();
+
+    m_moved.clear();
+    m_moved_positions.clear();
+}
+
 } // namespace fck
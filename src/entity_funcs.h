@@ -1,7 +1,9 @@
 #ifndef ENTITYFUNCS_FLAADMBKTWQG_H
 #define ENTITYFUNCS_FLAADMBKTWQG_H
 
+#include "fck/command_buffer.h"
 #include "fck/entity.h"
+#include "fck/inline_signal.h"
 #include "fck_common.h"
 #include "sigslot/signal.hpp"
 #include "skills/skill.h"
@@ -13,11 +15,23 @@ namespace fck
 
 struct entity_funcs
 {
+    // Entity moved since last flush, offsets of all its moves are summed up
+    struct Moved
+    {
+        Entity entity;
+        sf::Vector2f offset;
+    };
+
     // funcs
     // transform
     static void move(const Entity &entity, const sf::Vector2f &offset);
     static void setPosition(const Entity &entity, const sf::Vector2f &position);
     static void setParent(const Entity &entity, const Entity &parent);
+    // Records move of transform changed directly, move and setPosition record theirs. Moves are
+    // shared, so only systems writing Transform move entities, they never run concurrently.
+    static void markMoved(const Entity &entity, const sf::Vector2f &offset);
+    // Emits moved once for all entities moved since last flush, called once per tick
+    static void flushMoved();
 
     // state
     static void setState(const Entity &entity, entity_state::State state);
@@ -40,28 +54,61 @@ struct entity_funcs
     // script
     static void setScript(const Entity &entity, const std::string &script_name);
 
+    // Disconnects slots of all signals and drops not flushed moves, called when objects which
+    // connected them are destroyed
+    static void reset();
+
+    // Emits signal of entity at once, or by command buffer of non-exclusive system being updated
+    // by this thread. State, direction, drawable state and sound funcs emit their signals so,
+    // they can be called from non-exclusive systems.
+    template<typename Signal, typename... Args>
+    static void emit(Signal &signal, const Entity &entity, const Args &...args);
+
     // signals
-    static sigslot::signal<const Entity &, const sf::Vector2f &> moved;
-    static sigslot::signal<const Entity &, const Entity &> parent_changed;
-    static sigslot::signal<const Entity &, entity_state::State> state_changed;
-    static sigslot::signal<const Entity &, entity_state::Direction> direction_changed;
-    static sigslot::signal<const Entity &, const Entity &> collided;
+    // Gameplay signals are emitted on the main thread only, they take no locks. Signals
+    // with gui observers stay sigslot ones, which disconnect observers on destruction.
+    static InlineSignal<const std::vector<Moved> &> moved;
+    static InlineSignal<const Entity &, const Entity &> parent_changed;
+    static InlineSignal<const Entity &, entity_state::State> state_changed;
+    static InlineSignal<const Entity &, entity_state::Direction> direction_changed;
+    static InlineSignal<const Entity &, const Entity &> collided;
     static sigslot::signal<const Entity &, const Entity &, const Entity &> target_changed;
-    static sigslot::signal<const Entity &, const Entity &> marker_changed;
-    static sigslot::signal<const Entity &, const std::string &> drawable_state_changed;
+    static InlineSignal<const Entity &, const Entity &> marker_changed;
+    static InlineSignal<const Entity &, const std::string &> drawable_state_changed;
     static sigslot::signal<const Entity &, float> health_changed;
     static sigslot::signal<const Entity &, float> armor_changed;
-    static sigslot::signal<const Entity &, const std::string &> sound_playing;
-    static sigslot::signal<const Entity &, const std::string &> sound_stopped;
-    static sigslot::signal<const Entity &> all_sound_stopped;
+    static InlineSignal<const Entity &, const std::string &> sound_playing;
+    static InlineSignal<const Entity &, const std::string &> sound_stopped;
+    static InlineSignal<const Entity &> all_sound_stopped;
     static sigslot::signal<const Entity &, skill::Skill *> skill_applied;
     static sigslot::signal<const Entity &, skill::Skill *> skill_finished;
 
 private:
     entity_funcs() = delete;
     ~entity_funcs() = delete;
+
+private:
+    static std::vector<Moved> m_moved;
+    // Position in m_moved by entity index
+    static std::vector<int32_t> m_moved_positions;
 };
 
+template<typename Signal, typename... Args>
+void entity_funcs::emit(Signal &signal, const Entity &entity, const Args &...args)
+{
+    CommandBuffer *command_buffer = CommandBuffer::getCurrent();
+    if (!command_buffer)
+    {
+        signal(entity, args...);
+        return;
+    }
+
+    command_buffer->call([&signal, entity, args...]() {
+        if (entity.isValid())
+            signal(entity, args...);
+    });
+}
+
 } // namespace fck
 
 #endif // ENTITYFUNCS_FLAADMBKTWQG_H
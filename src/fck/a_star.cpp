@@ -1,5 +1,6 @@
 #include "a_star.h"
 
+#include <algorithm>
 #include <cmath>
 
 namespace fck
@@ -8,16 +9,6 @@ namespace fck
 std::vector<sf::Vector2i> PathFinder::m_directions
     = {{0, 1}, {1, 0}, {0, -1}, {-1, 0}, {-1, -1}, {1, 1}, {-1, 1}, {1, -1}};
 
-PathFinder::Node::Node(const sf::Vector2i coordinates, Node *parent)
-    : coordinates{coordinates}, parent{parent}, g{0}, h{0}
-{
-}
-
-uint32_t PathFinder::Node::score()
-{
-    return g + h;
-}
-
 sf::Vector2i PathFinder::Heuristic::delta(const sf::Vector2i &source, const sf::Vector2i &target)
 {
     return {std::abs(source.x - target.x), std::abs(source.y - target.y)};
@@ -41,8 +32,20 @@ uint32_t PathFinder::Heuristic::octagonal(const sf::Vector2i &source, const sf::
     return 10 * (d.x + d.y) + (-6) * std::min(d.x, d.y);
 }
 
-PathFinder::PathFinder(const Vector2D<int32_t> &walls)
-    : m_heuristic{&Heuristic::manhattan}, m_directions_count{8}
+PathFinder::PathFinder()
+    : m_walls{nullptr},
+      m_heuristic{Heuristic::MANHATTAN},
+      m_directions_count{8},
+      m_algorithm{A_STAR},
+      m_nodes_limit{0},
+      m_expanded_count{0},
+      m_nodes_limit_reached{false},
+      m_search_id{0},
+      m_jump_distances_valid{false}
+{
+}
+
+PathFinder::PathFinder(const Vector2D<int32_t> &walls) : PathFinder{}
 {
     setWalls(walls);
 }
@@ -55,10 +58,10 @@ const Vector2D<int32_t> *PathFinder::getWalls() const
 void PathFinder::setWalls(const Vector2D<int32_t> &grid)
 {
     m_walls = &grid;
+    m_jump_distances_valid = false;
 }
 
-void PathFinder::setHeuristic(
-    const std::function<uint32_t(const sf::Vector2i &, const sf::Vector2i &)> &heuristic)
+void PathFinder::setHeuristic(Heuristic::Type heuristic)
 {
     m_heuristic = heuristic;
 }
@@ -68,104 +71,356 @@ void PathFinder::setDiagonalMovement(bool enable)
     m_directions_count = enable ? 8 : 4;
 }
 
+PathFinder::Algorithm PathFinder::getAlgorithm() const
+{
+    return m_algorithm;
+}
+
+void PathFinder::setAlgorithm(Algorithm algorithm)
+{
+    m_algorithm = algorithm;
+}
+
+int32_t PathFinder::getNodesLimit() const
+{
+    return m_nodes_limit;
+}
+
+void PathFinder::setNodesLimit(int32_t nodes_limit)
+{
+    m_nodes_limit = nodes_limit;
+}
+
+int32_t PathFinder::getExpandedCount() const
+{
+    return m_expanded_count;
+}
+
+bool PathFinder::isNodesLimitReached() const
+{
+    return m_nodes_limit_reached;
+}
+
 std::vector<sf::Vector2i> PathFinder::findPath(
     const sf::Vector2i &source, const sf::Vector2i &target)
 {
-    if (detectCollision(target))
-        return {};
+    switch (m_heuristic)
+    {
+    case Heuristic::EUCLIDEAN:
+        return findPath(source, target, Heuristic::Euclidean{});
+    case Heuristic::OCTAGONAL:
+        return findPath(source, target, Heuristic::Octagonal{});
+    default:
+        return findPath(source, target, Heuristic::Manhattan{});
+    }
+}
 
-    Node *current = nullptr;
-    std::vector<Node *> opened;
-    std::vector<Node *> closed;
-    opened.reserve(100);
-    closed.reserve(100);
-    opened.push_back(new Node(source));
+int32_t PathFinder::findJumpDirections(
+    const sf::Vector2i &coordinates, int32_t parent, sf::Vector2i *directions) const
+{
+    int32_t count = 0;
 
-    while (!opened.empty())
+    if (parent == -1)
     {
-        auto current_it = opened.begin();
-        current = *current_it;
-
-        for (auto it = opened.begin(); it != opened.end(); it++)
+        for (const sf::Vector2i &direction : m_directions)
         {
-            auto node = *it;
-            if (node->score() <= current->score())
-            {
-                current = node;
-                current_it = it;
-            }
+            if (!detectCollision(coordinates + direction))
+                directions[count++] = direction;
         }
+        return count;
+    }
 
-        if (current->coordinates == target)
-            break;
+    sf::Vector2i parent_coordinates = m_walls->transformIndex(parent);
+    int32_t dx = (coordinates.x > parent_coordinates.x) - (coordinates.x < parent_coordinates.x);
+    int32_t dy = (coordinates.y > parent_coordinates.y) - (coordinates.y < parent_coordinates.y);
+
+    auto add = [&](const sf::Vector2i &direction) {
+        if (!detectCollision(coordinates + direction))
+            directions[count++] = direction;
+    };
+
+    const int32_t x = coordinates.x;
+    const int32_t y = coordinates.y;
+
+    // Natural successors and forced successors near walls
+    if (dx != 0 && dy != 0)
+    {
+        add({0, dy});
+        add({dx, 0});
+        add({dx, dy});
+        if (detectCollision({x - dx, y}))
+            add({-dx, dy});
+        if (detectCollision({x, y - dy}))
+            add({dx, -dy});
+    }
+    else if (dx != 0)
+    {
+        add({dx, 0});
+        if (detectCollision({x, y + 1}))
+            add({dx, 1});
+        if (detectCollision({x, y - 1}))
+            add({dx, -1});
+    }
+    else
+    {
+        add({0, dy});
+        if (detectCollision({x + 1, y}))
+            add({1, dy});
+        if (detectCollision({x - 1, y}))
+            add({-1, dy});
+    }
+
+    return count;
+}
+
+bool PathFinder::jump(
+    sf::Vector2i coordinates,
+    const sf::Vector2i &direction,
+    const sf::Vector2i &target,
+    sf::Vector2i &jump_point) const
+{
+    if (direction.x == 0 || direction.y == 0)
+        return jumpStraight(coordinates, direction, target, jump_point);
+
+    const int32_t dx = direction.x;
+    const int32_t dy = direction.y;
+
+    while (true)
+    {
+        coordinates += direction;
+        if (detectCollision(coordinates))
+            return false;
+
+        jump_point = coordinates;
+        if (coordinates == target)
+            return true;
+
+        const int32_t x = coordinates.x;
+        const int32_t y = coordinates.y;
+
+        if ((!detectCollision({x - dx, y + dy}) && detectCollision({x - dx, y}))
+            || (!detectCollision({x + dx, y - dy}) && detectCollision({x, y - dy})))
+            return true;
+
+        // Straight jumps find jump points for diagonal one
+        sf::Vector2i straight_jump_point;
+        if (jumpStraight(coordinates, {dx, 0}, target, straight_jump_point)
+            || jumpStraight(coordinates, {0, dy}, target, straight_jump_point))
+            return true;
+    }
+}
+
+bool PathFinder::jumpStraight(
+    const sf::Vector2i &coordinates,
+    const sf::Vector2i &direction,
+    const sf::Vector2i &target,
+    sf::Vector2i &jump_point) const
+{
+    const int32_t index = coordinates.y * m_walls->getSize2D().x + coordinates.x;
+    const int32_t distance = m_jump_distances[index * 4 + straightDirectionIndex(direction)];
+    const int32_t free_steps = std::abs(distance);
 
-        closed.push_back(current);
-        opened.erase(current_it);
+    // Target is on line before jump point or wall
+    int32_t target_steps = 0;
+    if (direction.x != 0 && target.y == coordinates.y)
+        target_steps = (target.x - coordinates.x) * direction.x;
+    else if (direction.y != 0 && target.x == coordinates.x)
+        target_steps = (target.y - coordinates.y) * direction.y;
 
-        for (uint i = 0; i < m_directions_count; ++i)
+    if (target_steps > 0 && target_steps <= free_steps)
+    {
+        jump_point = target;
+        return true;
+    }
+
+    if (distance <= 0)
+        return false;
+
+    jump_point = {coordinates.x + direction.x * distance, coordinates.y + direction.y * distance};
+    return true;
+}
+
+bool PathFinder::isStraightJumpPoint(
+    const sf::Vector2i &coordinates, const sf::Vector2i &direction) const
+{
+    const int32_t x = coordinates.x;
+    const int32_t y = coordinates.y;
+
+    if (direction.x != 0)
+    {
+        return (!detectCollision({x + direction.x, y + 1}) && detectCollision({x, y + 1}))
+            || (!detectCollision({x + direction.x, y - 1}) && detectCollision({x, y - 1}));
+    }
+
+    return (!detectCollision({x + 1, y + direction.y}) && detectCollision({x + 1, y}))
+        || (!detectCollision({x - 1, y + direction.y}) && detectCollision({x - 1, y}));
+}
+
+void PathFinder::prepareJumpDistances()
+{
+    if (m_jump_distances_valid)
+        return;
+
+    m_jump_distances_valid = true;
+
+    const int32_t cells_count = int32_t(m_walls->getSize());
+    m_jump_distances.assign(cells_count * 4, 0);
+
+    for (int32_t i = 0; i < 4; ++i)
+    {
+        const sf::Vector2i &direction = m_directions[i];
+        const bool positive = direction.x > 0 || direction.y > 0;
+
+        // Next cell in direction is processed before current one
+        for (int32_t j = 0; j < cells_count; ++j)
         {
-            sf::Vector2i new_coordinates(current->coordinates + m_directions[i]);
-            if (detectCollision(new_coordinates) || findNodeOnList(closed, new_coordinates))
+            int32_t index = positive ? cells_count - 1 - j : j;
+            sf::Vector2i next_coordinates = m_walls->transformIndex(index) + direction;
+
+            int32_t &distance = m_jump_distances[index * 4 + i];
+            if (detectCollision(next_coordinates))
             {
-                continue;
+                distance = 0;
             }
-
-            uint totalCost = current->g + ((i < 4) ? 10 : 14);
-
-            Node *successor = findNodeOnList(opened, new_coordinates);
-            if (successor == nullptr)
+            else if (isStraightJumpPoint(next_coordinates, direction))
             {
-                successor = new Node(new_coordinates, current);
-                successor->g = totalCost;
-                successor->h = m_heuristic(successor->coordinates, target);
-                opened.push_back(successor);
+                distance = 1;
             }
-            else if (totalCost < successor->g)
+            else
             {
-                successor->parent = current;
-                successor->g = totalCost;
+                int32_t next_index = next_coordinates.y * m_walls->getSize2D().x
+                    + next_coordinates.x;
+                int32_t next_distance = m_jump_distances[next_index * 4 + i];
+                distance = next_distance > 0 ? next_distance + 1 : next_distance - 1;
             }
         }
     }
+}
+
+int32_t PathFinder::straightDirectionIndex(const sf::Vector2i &direction)
+{
+    // Order of first directions
+    if (direction.y > 0)
+        return 0;
+    if (direction.x > 0)
+        return 1;
+    if (direction.y < 0)
+        return 2;
+    return 3;
+}
 
-    std::vector<sf::Vector2i> path;
-    while (current != nullptr)
+bool PathFinder::detectCollision(const sf::Vector2i &coordinates) const
+{
+    if (!isInside(coordinates))
+        return true;
+    return (*m_walls)[coordinates.y * m_walls->getSize2D().x + coordinates.x] > 0;
+}
+
+bool PathFinder::isInside(const sf::Vector2i &coordinates) const
+{
+    const sf::Vector2i &size = m_walls->getSize2D();
+    return coordinates.x >= 0 && coordinates.y >= 0 && coordinates.x < size.x
+        && coordinates.y < size.y;
+}
+
+void PathFinder::prepareNodes()
+{
+    if (m_nodes.size() != m_walls->getSize())
     {
-        path.push_back(current->coordinates);
-        current = current->parent;
+        m_nodes.assign(m_walls->getSize(), Node{0, 0, -1, CLOSED, 0});
+        m_search_id = 0;
     }
 
-    releaseNodes(opened);
-    releaseNodes(closed);
+    // Search id wrapped, old ids can't be told from new ones
+    if (++m_search_id == 0)
+    {
+        for (Node &node : m_nodes)
+            node.search_id = 0;
+        m_search_id = 1;
+    }
 
-    return path;
+    m_opened.clear();
 }
 
-bool PathFinder::detectCollision(const sf::Vector2i coordinates)
+void PathFinder::pushOpened(int32_t index)
 {
-    if (coordinates.x < 0 || coordinates.y < 0)
-        return true;
-    return m_walls->getData(coordinates) > 0;
+    m_nodes[index].heap_index = int32_t(m_opened.size());
+    m_opened.push_back(index);
+    siftUp(int32_t(m_opened.size()) - 1);
 }
 
-PathFinder::Node *PathFinder::findNodeOnList(
-    const std::vector<Node *> &nodes, const sf::Vector2i coordinates)
+int32_t PathFinder::popOpened()
 {
-    for (auto node : nodes)
+    int32_t index = m_opened.front();
+    m_nodes[index].heap_index = CLOSED;
+
+    m_opened.front() = m_opened.back();
+    m_opened.pop_back();
+
+    if (!m_opened.empty())
     {
-        if (node->coordinates == coordinates)
-            return node;
+        m_nodes[m_opened.front()].heap_index = 0;
+        siftDown(0);
     }
-    return nullptr;
+
+    return index;
 }
 
-void PathFinder::releaseNodes(std::vector<Node *> &nodes)
+void PathFinder::siftUp(int32_t heap_index)
 {
-    for (auto it = nodes.begin(); it != nodes.end();)
+    int32_t index = m_opened[heap_index];
+    while (heap_index > 0)
     {
-        delete *it;
-        it = nodes.erase(it);
+        int32_t parent_heap_index = (heap_index - 1) / 2;
+        int32_t parent_index = m_opened[parent_heap_index];
+        if (!lessOpened(index, parent_index))
+            break;
+
+        m_opened[heap_index] = parent_index;
+        m_nodes[parent_index].heap_index = heap_index;
+        heap_index = parent_heap_index;
     }
+
+    m_opened[heap_index] = index;
+    m_nodes[index].heap_index = heap_index;
+}
+
+void PathFinder::siftDown(int32_t heap_index)
+{
+    int32_t size = int32_t(m_opened.size());
+    int32_t index = m_opened[heap_index];
+    while (true)
+    {
+        int32_t child_heap_index = heap_index * 2 + 1;
+        if (child_heap_index >= size)
+            break;
+
+        if (child_heap_index + 1 < size
+            && lessOpened(m_opened[child_heap_index + 1], m_opened[child_heap_index]))
+            ++child_heap_index;
+
+        int32_t child_index = m_opened[child_heap_index];
+        if (!lessOpened(child_index, index))
+            break;
+
+        m_opened[heap_index] = child_index;
+        m_nodes[child_index].heap_index = heap_index;
+        heap_index = child_heap_index;
+    }
+
+    m_opened[heap_index] = index;
+    m_nodes[index].heap_index = heap_index;
+}
+
+bool PathFinder::lessOpened(int32_t first, int32_t second) const
+{
+    const Node &first_node = m_nodes[first];
+    const Node &second_node = m_nodes[second];
+
+    // Deeper node first on same score, it is closer to target
+    if (first_node.score == second_node.score)
+        return first_node.g > second_node.g;
+    return first_node.score < second_node.score;
 }
 
 } // namespace fck
@@ -1,66 +1,378 @@
 #ifndef A_STAR_FTXEOUQWCTXW_H
 #define A_STAR_FTXEOUQWCTXW_H
 
+#include "perf_counters.h"
 #include "vector_2d.h"
 
 #include "SFML/System/Vector2.hpp"
 
 #include <cstdint>
-#include <functional>
+#include <vector>
 
 namespace fck
 {
 
 class WorldGrid;
 
+// A* over walls grid (0 - free cell, > 0 - wall). Nodes of every cell are kept between
+// searches and reset lazily by search id, so long-lived path finder doesn't allocate
+// per search. Open list is indexed binary heap with decrease-key.
+// Jump point search expands only jump points of uniform-cost grid with diagonal movement,
+// path has same format and cost as path of A*.
 class PathFinder
 {
 public:
-    struct Node
-    {
-        Node(const sf::Vector2i coordinates, Node *parent = nullptr);
-
-        uint32_t score();
-
-        sf::Vector2i coordinates;
-        Node *parent;
-        uint32_t g;
-        uint32_t h;
-    };
-
     struct Heuristic
     {
+        enum Type
+        {
+            MANHATTAN,
+            EUCLIDEAN,
+            OCTAGONAL
+        };
+
         static sf::Vector2i delta(const sf::Vector2i &source, const sf::Vector2i &target);
         static uint32_t manhattan(const sf::Vector2i &source, const sf::Vector2i &target);
         static uint32_t euclidean(const sf::Vector2i &source, const sf::Vector2i &target);
         static uint32_t octagonal(const sf::Vector2i &source, const sf::Vector2i &target);
+
+        struct Manhattan
+        {
+            uint32_t operator()(const sf::Vector2i &source, const sf::Vector2i &target) const
+            {
+                return manhattan(source, target);
+            }
+        };
+
+        struct Euclidean
+        {
+            uint32_t operator()(const sf::Vector2i &source, const sf::Vector2i &target) const
+            {
+                return euclidean(source, target);
+            }
+        };
+
+        struct Octagonal
+        {
+            uint32_t operator()(const sf::Vector2i &source, const sf::Vector2i &target) const
+            {
+                return octagonal(source, target);
+            }
+        };
     };
 
+    enum Algorithm
+    {
+        A_STAR,
+        JUMP_POINT_SEARCH
+    };
+
+    PathFinder();
     PathFinder(const Vector2D<int32_t> &walls);
     ~PathFinder() = default;
 
     const Vector2D<int32_t> *getWalls() const;
+    // Walls are read by every search, but jump distances are rebuilt only by this call
     void setWalls(const Vector2D<int32_t> &grid);
 
-    void setHeuristic(
-        const std::function<uint32_t(const sf::Vector2i &, const sf::Vector2i &)> &heuristic);
+    void setHeuristic(Heuristic::Type heuristic);
     void setDiagonalMovement(bool enable);
 
+    Algorithm getAlgorithm() const;
+    // Jump point search works only with diagonal movement, A* is used without it
+    void setAlgorithm(Algorithm algorithm);
+
+    // Search stops with empty path after expanding this count of nodes, 0 - no limit
+    int32_t getNodesLimit() const;
+    void setNodesLimit(int32_t nodes_limit);
+
+    // Of last search
+    int32_t getExpandedCount() const;
+    bool isNodesLimitReached() const;
+
+    // Path from target to source, both included. Empty if target isn't reachable
     std::vector<sf::Vector2i> findPath(const sf::Vector2i &source, const sf::Vector2i &target);
 
+    template<typename H>
+    std::vector<sf::Vector2i> findPath(
+        const sf::Vector2i &source, const sf::Vector2i &target, const H &heuristic);
+
 private:
-    bool detectCollision(const sf::Vector2i coordinates);
-    Node *findNodeOnList(const std::vector<Node *> &nodes, const sf::Vector2i coordinates);
-    void releaseNodes(std::vector<Node *> &nodes);
+    struct Node
+    {
+        uint32_t g;
+        uint32_t score;
+        int32_t parent;
+        // Index in open heap, CLOSED when node is expanded
+        int32_t heap_index;
+        // Node is valid only in search with same id
+        uint32_t search_id;
+    };
+
+    static constexpr int32_t CLOSED = -1;
+
+    template<typename H>
+    std::vector<sf::Vector2i> findPathAStar(
+        const sf::Vector2i &source, const sf::Vector2i &target, const H &heuristic);
+
+    template<typename H>
+    std::vector<sf::Vector2i> findPathJumpPoints(
+        const sf::Vector2i &source, const sf::Vector2i &target, const H &heuristic);
+
+    // Directions to successors of node by parent, all directions for node without parent
+    int32_t findJumpDirections(
+        const sf::Vector2i &coordinates, int32_t parent, sf::Vector2i *directions) const;
+    bool jump(
+        sf::Vector2i coordinates,
+        const sf::Vector2i &direction,
+        const sf::Vector2i &target,
+        sf::Vector2i &jump_point) const;
+    // Straight jump by precomputed distances
+    bool jumpStraight(
+        const sf::Vector2i &coordinates,
+        const sf::Vector2i &direction,
+        const sf::Vector2i &target,
+        sf::Vector2i &jump_point) const;
+    bool isStraightJumpPoint(const sf::Vector2i &coordinates, const sf::Vector2i &direction) const;
+    void prepareJumpDistances();
+    static int32_t straightDirectionIndex(const sf::Vector2i &direction);
+
+    bool detectCollision(const sf::Vector2i &coordinates) const;
+    bool isInside(const sf::Vector2i &coordinates) const;
+    void prepareNodes();
+
+    void pushOpened(int32_t index);
+    int32_t popOpened();
+    void siftUp(int32_t heap_index);
+    void siftDown(int32_t heap_index);
+    bool lessOpened(int32_t first, int32_t second) const;
 
 private:
     static std::vector<sf::Vector2i> m_directions;
 
     const Vector2D<int32_t> *m_walls;
-    std::function<uint32_t(const sf::Vector2i &, const sf::Vector2i &)> m_heuristic;
+    Heuristic::Type m_heuristic;
     int32_t m_directions_count;
+    Algorithm m_algorithm;
+    int32_t m_nodes_limit;
+
+    int32_t m_expanded_count;
+    bool m_nodes_limit_reached;
+
+    std::vector<Node> m_nodes;
+    std::vector<int32_t> m_opened;
+    uint32_t m_search_id;
+
+    // Per cell and straight direction: steps to next jump point if positive,
+    // otherwise negative count of free steps until wall (JPS+)
+    std::vector<int32_t> m_jump_distances;
+    bool m_jump_distances_valid;
 };
 
+template<typename H>
+std::vector<sf::Vector2i> PathFinder::findPath(
+    const sf::Vector2i &source, const sf::Vector2i &target, const H &heuristic)
+{
+    FCK_PERF_COUNTER_ADD("PathFinder::findPath calls", 1);
+
+    m_expanded_count = 0;
+    m_nodes_limit_reached = false;
+
+    // Source can be wall cell if agent was pushed into it, search leaves it by free neighbors
+    if (!m_walls || detectCollision(target) || !isInside(source))
+        return {};
+
+    prepareNodes();
+
+    if (m_algorithm == JUMP_POINT_SEARCH && m_directions_count == 8)
+    {
+        prepareJumpDistances();
+        return findPathJumpPoints(source, target, heuristic);
+    }
+    return findPathAStar(source, target, heuristic);
+}
+
+template<typename H>
+std::vector<sf::Vector2i> PathFinder::findPathAStar(
+    const sf::Vector2i &source, const sf::Vector2i &target, const H &heuristic)
+{
+    const int32_t width = m_walls->getSize2D().x;
+    const int32_t target_index = target.y * width + target.x;
+
+    int32_t source_index = source.y * width + source.x;
+    Node &source_node = m_nodes[source_index];
+    source_node.g = 0;
+    source_node.score = heuristic(source, target);
+    source_node.parent = -1;
+    source_node.search_id = m_search_id;
+    pushOpened(source_index);
+
+    int32_t expanded_count = 0;
+    bool found = false;
+
+    while (!m_opened.empty())
+    {
+        int32_t current_index = popOpened();
+        if (current_index == target_index)
+        {
+            found = true;
+            break;
+        }
+
+        if (m_nodes_limit > 0 && expanded_count >= m_nodes_limit)
+        {
+            m_nodes_limit_reached = true;
+            break;
+        }
+
+        ++expanded_count;
+
+        const Node &current = m_nodes[current_index];
+        sf::Vector2i current_coordinates = m_walls->transformIndex(current_index);
+
+        for (int32_t i = 0; i < m_directions_count; ++i)
+        {
+            sf::Vector2i new_coordinates = current_coordinates + m_directions[i];
+            if (detectCollision(new_coordinates))
+                continue;
+
+            int32_t new_index = new_coordinates.y * width + new_coordinates.x;
+            Node &successor = m_nodes[new_index];
+
+            uint32_t total_cost = current.g + ((i < 4) ? 10 : 14);
+
+            if (successor.search_id != m_search_id)
+            {
+                successor.g = total_cost;
+                successor.score = total_cost + heuristic(new_coordinates, target);
+                successor.parent = current_index;
+                successor.search_id = m_search_id;
+                pushOpened(new_index);
+            }
+            else if (successor.heap_index != CLOSED && total_cost < successor.g)
+            {
+                successor.score = successor.score - successor.g + total_cost;
+                successor.g = total_cost;
+                successor.parent = current_index;
+                siftUp(successor.heap_index);
+            }
+        }
+    }
+
+    FCK_PERF_COUNTER_ADD("PathFinder::findPath expanded nodes", expanded_count);
+    m_expanded_count = expanded_count;
+
+    m_opened.clear();
+
+    std::vector<sf::Vector2i> path;
+    if (!found)
+        return path;
+
+    for (int32_t index = target_index; index != -1; index = m_nodes[index].parent)
+        path.push_back(m_walls->transformIndex(index));
+
+    return path;
+}
+
+template<typename H>
+std::vector<sf::Vector2i> PathFinder::findPathJumpPoints(
+    const sf::Vector2i &source, const sf::Vector2i &target, const H &heuristic)
+{
+    const int32_t width = m_walls->getSize2D().x;
+    const int32_t target_index = target.y * width + target.x;
+
+    int32_t source_index = source.y * width + source.x;
+    Node &source_node = m_nodes[source_index];
+    source_node.g = 0;
+    source_node.score = heuristic(source, target);
+    source_node.parent = -1;
+    source_node.search_id = m_search_id;
+    pushOpened(source_index);
+
+    int32_t expanded_count = 0;
+    bool found = false;
+
+    sf::Vector2i directions[8];
+
+    while (!m_opened.empty())
+    {
+        int32_t current_index = popOpened();
+        if (current_index == target_index)
+        {
+            found = true;
+            break;
+        }
+
+        if (m_nodes_limit > 0 && expanded_count >= m_nodes_limit)
+        {
+            m_nodes_limit_reached = true;
+            break;
+        }
+
+        ++expanded_count;
+
+        const Node &current = m_nodes[current_index];
+        sf::Vector2i current_coordinates = m_walls->transformIndex(current_index);
+
+        int32_t directions_count
+            = findJumpDirections(current_coordinates, current.parent, directions);
+
+        for (int32_t i = 0; i < directions_count; ++i)
+        {
+            sf::Vector2i jump_point;
+            if (!jump(current_coordinates, directions[i], target, jump_point))
+                continue;
+
+            int32_t new_index = jump_point.y * width + jump_point.x;
+            Node &successor = m_nodes[new_index];
+
+            // Jump points are on straight or diagonal line
+            uint32_t total_cost = current.g + Heuristic::octagonal(current_coordinates, jump_point);
+
+            if (successor.search_id != m_search_id)
+            {
+                successor.g = total_cost;
+                successor.score = total_cost + heuristic(jump_point, target);
+                successor.parent = current_index;
+                successor.search_id = m_search_id;
+                pushOpened(new_index);
+            }
+            else if (successor.heap_index != CLOSED && total_cost < successor.g)
+            {
+                successor.score = successor.score - successor.g + total_cost;
+                successor.g = total_cost;
+                successor.parent = current_index;
+                siftUp(successor.heap_index);
+            }
+        }
+    }
+
+    FCK_PERF_COUNTER_ADD("PathFinder::findPath expanded nodes", expanded_count);
+    m_expanded_count = expanded_count;
+
+    m_opened.clear();
+
+    std::vector<sf::Vector2i> path;
+    if (!found)
+        return path;
+
+    // Cells between jump points
+    for (int32_t index = target_index; m_nodes[index].parent != -1; index = m_nodes[index].parent)
+    {
+        sf::Vector2i coordinates = m_walls->transformIndex(index);
+        sf::Vector2i parent_coordinates = m_walls->transformIndex(m_nodes[index].parent);
+        sf::Vector2i step
+            = {(parent_coordinates.x > coordinates.x) - (parent_coordinates.x < coordinates.x),
+               (parent_coordinates.y > coordinates.y) - (parent_coordinates.y < coordinates.y)};
+
+        for (; coordinates != parent_coordinates; coordinates += step)
+            path.push_back(coordinates);
+    }
+    path.push_back(source);
+
+    return path;
+}
+
 } // namespace fck
 
 #endif // A_STAR_FTXEOUQWCTXW_H
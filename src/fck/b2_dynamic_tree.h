@@ -1,14 +1,20 @@
 #ifndef B2DYNAMICTREE_DAYPZRBBUQHC_H
 #define B2DYNAMICTREE_DAYPZRBBUQHC_H
 
+#include "perf_counters.h"
+#include "profiler.h"
+
 #include <SFML/Graphics/Rect.hpp>
 
 #include <float.h>
+#include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <cstdint>
 #include <cstring>
 #include <functional>
 #include <stack>
+#include <vector>
 
 namespace fck::b2
 {
@@ -114,6 +120,12 @@ public:
     /// Create a proxy. Provide a tight fitting AABB and a userData pointer.
     int32_t createProxy(const AABB &aabb, T user_data);
 
+    /// Create proxies for all aabbs at once. The whole tree is rebuilt top-down
+    /// by median splits, which is faster than inserting proxies one by one.
+    /// @return proxy ids in order of aabbs.
+    std::vector<int32_t> createProxies(
+        const std::vector<AABB> &aabbs, const std::vector<T> &user_data);
+
     /// Destroy a proxy. This asserts if the id is invalid.
     void destroyProxy(int32_t proxy_id);
 
@@ -123,6 +135,14 @@ public:
     /// @return true if the proxy was re-inserted.
     bool moveProxy(int32_t proxy_id, const AABB &aabb1, const sf::Vector2f &displacement);
 
+    /// Move many proxies at once. Proxies that left their fattened AABB are re-inserted
+    /// one by one, or the whole tree is rebuilt top-down when a large part of them did.
+    /// @return count of proxies that were re-inserted.
+    int32_t moveProxies(
+        const std::vector<int32_t> &proxy_ids,
+        const std::vector<AABB> &aabbs,
+        const std::vector<sf::Vector2f> &displacements);
+
     /// Get proxy user data.
     /// @return the proxy user data or 0 if the id is invalid.
     T getUserData(int32_t proxy_id) const;
@@ -172,6 +192,12 @@ private:
 
     int32_t balance(int32_t i_a);
 
+    AABB computeFatAABB(const AABB &aabb, const sf::Vector2f &displacement) const;
+    bool isFatAABBValid(int32_t proxy_id, const AABB &aabb, const AABB &fat_aabb) const;
+
+    void rebuildTopDown();
+    int32_t buildTopDown(int32_t *leaves, int32_t count);
+
     int32_t computeHeight() const;
     int32_t computeHeight(int32_t node_id) const;
 
@@ -238,6 +264,33 @@ int32_t DynamicTree<T>::createProxy(const AABB &aabb, T user_data)
     return proxy_id;
 }
 
+template<typename T>
+std::vector<int32_t> DynamicTree<T>::createProxies(
+    const std::vector<AABB> &aabbs, const std::vector<T> &user_data)
+{
+    assert(aabbs.size() == user_data.size());
+
+    std::vector<int32_t> proxy_ids(aabbs.size());
+
+    sf::Vector2f r(AABB_EXTENSION, AABB_EXTENSION);
+    for (std::size_t i = 0; i < aabbs.size(); ++i)
+    {
+        int32_t proxy_id = allocateNode();
+
+        m_nodes[proxy_id].aabb.lower_bound = aabbs[i].lower_bound - r;
+        m_nodes[proxy_id].aabb.upper_bound = aabbs[i].upper_bound + r;
+        m_nodes[proxy_id].user_data = user_data[i];
+        m_nodes[proxy_id].height = 0;
+        m_nodes[proxy_id].moved = true;
+
+        proxy_ids[i] = proxy_id;
+    }
+
+    rebuildTopDown();
+
+    return proxy_ids;
+}
+
 template<typename T>
 void DynamicTree<T>::destroyProxy(int32_t proxy_id)
 {
@@ -255,62 +308,69 @@ bool DynamicTree<T>::moveProxy(int32_t proxy_id, const AABB &aabb, const sf::Vec
 
     assert(m_nodes[proxy_id].isLeaf());
 
-    // Extend AABB
-    AABB fat_aabb;
-    sf::Vector2f r(AABB_EXTENSION, AABB_EXTENSION);
-    fat_aabb.lower_bound = aabb.lower_bound - r;
-    fat_aabb.upper_bound = aabb.upper_bound + r;
+    AABB fat_aabb = computeFatAABB(aabb, displacement);
+    if (isFatAABBValid(proxy_id, aabb, fat_aabb))
+        return false;
 
-    // Predict AABB movement
-    sf::Vector2f d = AABB_MULTIPLIER * displacement;
+    removeLeaf(proxy_id);
 
-    if (d.x < 0.0f)
-    {
-        fat_aabb.lower_bound.x += d.x;
-    }
-    else
+    m_nodes[proxy_id].aabb = fat_aabb;
+
+    insertLeaf(proxy_id);
+
+    m_nodes[proxy_id].moved = true;
+
+    return true;
+}
+
+template<typename T>
+int32_t DynamicTree<T>::moveProxies(
+    const std::vector<int32_t> &proxy_ids,
+    const std::vector<AABB> &aabbs,
+    const std::vector<sf::Vector2f> &displacements)
+{
+    assert(proxy_ids.size() == aabbs.size() && proxy_ids.size() == displacements.size());
+
+    std::vector<std::pair<int32_t, AABB>> reinserted;
+    for (std::size_t i = 0; i < proxy_ids.size(); ++i)
     {
-        fat_aabb.upper_bound.x += d.x;
+        int32_t proxy_id = proxy_ids[i];
+
+        assert(0 <= proxy_id && proxy_id < m_node_capacity);
+        assert(m_nodes[proxy_id].isLeaf());
+
+        AABB fat_aabb = computeFatAABB(aabbs[i], displacements[i]);
+        if (!isFatAABBValid(proxy_id, aabbs[i], fat_aabb))
+            reinserted.emplace_back(proxy_id, fat_aabb);
     }
 
-    if (d.y < 0.0f)
+    if (reinserted.empty())
+        return 0;
+
+    // Rebuild costs about as much as re-inserting a quarter of leaves
+    int32_t leaves_count = (m_node_count + 1) / 2;
+    if (int32_t(reinserted.size()) * 4 >= leaves_count)
     {
-        fat_aabb.lower_bound.y += d.y;
+        for (auto &[proxy_id, fat_aabb] : reinserted)
+        {
+            m_nodes[proxy_id].aabb = fat_aabb;
+            m_nodes[proxy_id].moved = true;
+        }
+
+        rebuildTopDown();
     }
     else
     {
-        fat_aabb.upper_bound.y += d.y;
-    }
-
-    const AABB &tree_aabb = m_nodes[proxy_id].aabb;
-    if (tree_aabb.contains(aabb))
-    {
-        // The tree AABB still contains the object, but it might be too large.
-        // Perhaps the object was moving fast but has since gone to sleep.
-        // The huge AABB is larger than the new fat AABB.
-        AABB huge_aabb;
-        huge_aabb.lower_bound = fat_aabb.lower_bound - 4.0f * r;
-        huge_aabb.upper_bound = fat_aabb.upper_bound + 4.0f * r;
-
-        if (huge_aabb.contains(tree_aabb))
+        for (auto &[proxy_id, fat_aabb] : reinserted)
         {
-            // The tree AABB contains the object AABB and the tree AABB is
-            // not too large. No tree update needed.
-            return false;
+            removeLeaf(proxy_id);
+            m_nodes[proxy_id].aabb = fat_aabb;
+            insertLeaf(proxy_id);
+            m_nodes[proxy_id].moved = true;
         }
-
-        // Otherwise the tree AABB is huge and needs to be shrunk
     }
 
-    removeLeaf(proxy_id);
-
-    m_nodes[proxy_id].aabb = fat_aabb;
-
-    insertLeaf(proxy_id);
-
-    m_nodes[proxy_id].moved = true;
-
-    return true;
+    return reinserted.size();
 }
 
 template<typename T>
@@ -344,11 +404,15 @@ const AABB &DynamicTree<T>::getFatAABB(int32_t proxy_id) const
 template<typename T>
 void DynamicTree<T>::querry(const AABB &aabb, const std::function<bool(int32_t)> &callback)
 {
+    FCK_PROFILE_ZONE("DynamicTree::querry");
+
     //b2GrowableStack<int32, 256> stack;
     std::stack<int32_t> stack;
 
     stack.push(m_root);
 
+    int64_t visited_nodes = 0;
+
     while (stack.size() > 0)
     {
         int32_t node_id = stack.top();
@@ -360,6 +424,7 @@ void DynamicTree<T>::querry(const AABB &aabb, const std::function<bool(int32_t)>
         }
 
         const TreeNode<T> *node = m_nodes + node_id;
+        ++visited_nodes;
 
         if (b2TestOverlap(node->aabb, aabb))
         {
@@ -368,7 +433,7 @@ void DynamicTree<T>::querry(const AABB &aabb, const std::function<bool(int32_t)>
                 bool proceed = callback(node_id);
                 if (proceed == false)
                 {
-                    return;
+                    break;
                 }
             }
             else
@@ -378,6 +443,9 @@ void DynamicTree<T>::querry(const AABB &aabb, const std::function<bool(int32_t)>
             }
         }
     }
+
+    FCK_PERF_COUNTER_ADD("DynamicTree::querry calls", 1);
+    FCK_PERF_COUNTER_ADD("DynamicTree::querry visited nodes", visited_nodes);
 }
 
 template<typename T>
@@ -493,6 +561,123 @@ int32_t DynamicTree<T>::allocateNode()
     return node_id;
 }
 
+// Extend AABB and predict its movement.
+template<typename T>
+AABB DynamicTree<T>::computeFatAABB(const AABB &aabb, const sf::Vector2f &displacement) const
+{
+    AABB fat_aabb;
+    sf::Vector2f r(AABB_EXTENSION, AABB_EXTENSION);
+    fat_aabb.lower_bound = aabb.lower_bound - r;
+    fat_aabb.upper_bound = aabb.upper_bound + r;
+
+    sf::Vector2f d = AABB_MULTIPLIER * displacement;
+
+    if (d.x < 0.0f)
+    {
+        fat_aabb.lower_bound.x += d.x;
+    }
+    else
+    {
+        fat_aabb.upper_bound.x += d.x;
+    }
+
+    if (d.y < 0.0f)
+    {
+        fat_aabb.lower_bound.y += d.y;
+    }
+    else
+    {
+        fat_aabb.upper_bound.y += d.y;
+    }
+
+    return fat_aabb;
+}
+
+// Tree AABB of proxy may stay if it contains the object and is not too large.
+template<typename T>
+bool DynamicTree<T>::isFatAABBValid(int32_t proxy_id, const AABB &aabb, const AABB &fat_aabb) const
+{
+    const AABB &tree_aabb = m_nodes[proxy_id].aabb;
+    if (!tree_aabb.contains(aabb))
+        return false;
+
+    // The tree AABB still contains the object, but it might be too large.
+    // Perhaps the object was moving fast but has since gone to sleep.
+    // The huge AABB is larger than the new fat AABB.
+    sf::Vector2f r(AABB_EXTENSION, AABB_EXTENSION);
+    AABB huge_aabb;
+    huge_aabb.lower_bound = fat_aabb.lower_bound - 4.0f * r;
+    huge_aabb.upper_bound = fat_aabb.upper_bound + 4.0f * r;
+
+    return huge_aabb.contains(tree_aabb);
+}
+
+// Keep leaves, free internal nodes and build them again.
+template<typename T>
+void DynamicTree<T>::rebuildTopDown()
+{
+    std::vector<int32_t> leaves;
+    leaves.reserve(m_node_count);
+
+    for (int32_t i = 0; i < m_node_capacity; ++i)
+    {
+        if (m_nodes[i].height < 0)
+            continue;
+
+        if (m_nodes[i].isLeaf())
+            leaves.push_back(i);
+        else
+            freeNode(i);
+    }
+
+    m_root = NULL_TREE_NODE;
+    if (!leaves.empty())
+    {
+        m_root = buildTopDown(leaves.data(), leaves.size());
+        m_nodes[m_root].parent = NULL_TREE_NODE;
+    }
+}
+
+// Build subtree of leaves, split by median of centers along longest axis.
+template<typename T>
+int32_t DynamicTree<T>::buildTopDown(int32_t *leaves, int32_t count)
+{
+    if (count == 1)
+        return leaves[0];
+
+    sf::Vector2f lower = m_nodes[leaves[0]].aabb.center();
+    sf::Vector2f upper = lower;
+    for (int32_t i = 1; i < count; ++i)
+    {
+        sf::Vector2f center = m_nodes[leaves[i]].aabb.center();
+        lower = {std::min(lower.x, center.x), std::min(lower.y, center.y)};
+        upper = {std::max(upper.x, center.x), std::max(upper.y, center.y)};
+    }
+
+    bool split_x = (upper.x - lower.x) >= (upper.y - lower.y);
+    int32_t half = count / 2;
+
+    std::nth_element(leaves, leaves + half, leaves + count, [this, split_x](int32_t a, int32_t b) {
+        sf::Vector2f center_a = m_nodes[a].aabb.center();
+        sf::Vector2f center_b = m_nodes[b].aabb.center();
+        return split_x ? center_a.x < center_b.x : center_a.y < center_b.y;
+    });
+
+    int32_t child1 = buildTopDown(leaves, half);
+    int32_t child2 = buildTopDown(leaves + half, count - half);
+
+    int32_t parent = allocateNode();
+    m_nodes[parent].child1 = child1;
+    m_nodes[parent].child2 = child2;
+    m_nodes[parent].aabb.combine(m_nodes[child1].aabb, m_nodes[child2].aabb);
+    m_nodes[parent].height = 1 + std::max(m_nodes[child1].height, m_nodes[child2].height);
+
+    m_nodes[child1].parent = parent;
+    m_nodes[child2].parent = parent;
+
+    return parent;
+}
+
 // Return a node to the pool.
 template<typename T>
 void DynamicTree<T>::freeNode(int32_t node_id)
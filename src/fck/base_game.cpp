@@ -1,12 +1,21 @@
 #include "base_game.h"
+#include "perf_counters.h"
+#include "profiler.h"
 
 #include <spdlog/spdlog.h>
+#include <SFML/System/Sleep.hpp>
 #include <SFML/Window/Event.hpp>
 
 namespace fck
 {
 
-BaseGame::BaseGame() : m_running{false}, m_tick_time{sf::milliseconds(16)}
+BaseGame::BaseGame()
+    : m_running{false},
+      m_tick_time{sf::milliseconds(16)},
+      m_ticks_count{0},
+      m_headless{false},
+      m_ticks_limit{0},
+      m_real_time{false}
 {
     m_render_window.setVerticalSyncEnabled(false);
 }
@@ -17,6 +26,9 @@ BaseGame::~BaseGame()
 
 int32_t BaseGame::exec()
 {
+    if (m_headless)
+        return execHeadless();
+
     m_running = true;
 
     sf::Clock loop_clock;
@@ -27,6 +39,9 @@ int32_t BaseGame::exec()
     {
         lag += (elapsed = loop_clock.restart());
 
+        Profiler::nextFrame();
+        PerfCounters::nextFrame();
+
         sf::Event e;
         while (m_render_window.pollEvent(e))
             event(e);
@@ -34,6 +49,7 @@ int32_t BaseGame::exec()
         while (lag >= m_tick_time)
         {
             update(m_tick_time);
+            ++m_ticks_count;
             lag -= m_tick_time;
         }
 
@@ -43,6 +59,44 @@ int32_t BaseGame::exec()
     return 0;
 }
 
+int32_t BaseGame::execHeadless()
+{
+    m_running = true;
+
+    spdlog::info("Run headless, ticks limit: {}", m_ticks_limit);
+
+    sf::Clock run_clock;
+    uint64_t first_tick = m_ticks_count;
+
+    while (m_running && (m_ticks_limit == 0 || m_ticks_count - first_tick < m_ticks_limit))
+    {
+        Profiler::nextFrame();
+        PerfCounters::nextFrame();
+
+        // Virtual clock, tick time does not depend on time of update
+        update(m_tick_time);
+        ++m_ticks_count;
+
+        if (m_real_time)
+        {
+            sf::Time ahead
+                = sf::microseconds(
+                      m_tick_time.asMicroseconds() * int64_t(m_ticks_count - first_tick))
+                - run_clock.getElapsedTime();
+            if (ahead > sf::Time::Zero)
+                sf::sleep(ahead);
+        }
+    }
+
+    sf::Time run_time = run_clock.getElapsedTime();
+    spdlog::info(
+        "Headless run finished: {} ticks in {:.3f} s",
+        m_ticks_count - first_tick,
+        run_time.asSeconds());
+
+    return 0;
+}
+
 void BaseGame::exit()
 {
     spdlog::info("Exit game");
@@ -54,6 +108,36 @@ sf::RenderWindow &BaseGame::getRrenderWindow()
     return m_render_window;
 }
 
+bool BaseGame::isHeadless() const
+{
+    return m_headless;
+}
+
+void BaseGame::setHeadless(bool headless)
+{
+    m_headless = headless;
+}
+
+void BaseGame::setTicksLimit(uint64_t ticks_limit)
+{
+    m_ticks_limit = ticks_limit;
+}
+
+void BaseGame::setRealTime(bool real_time)
+{
+    m_real_time = real_time;
+}
+
+uint64_t BaseGame::getTicksCount() const
+{
+    return m_ticks_count;
+}
+
+const sf::Time &BaseGame::getTickTime() const
+{
+    return m_tick_time;
+}
+
 void BaseGame::event(const sf::Event &event)
 {
 }
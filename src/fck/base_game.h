@@ -19,14 +19,34 @@ public:
 
     sf::RenderWindow &getRrenderWindow();
 
+    // Headless game has no window and events, every tick gets fixed tick time
+    bool isHeadless() const;
+    void setHeadless(bool headless);
+
+    // Ticks to run in headless mode, 0 runs until exit
+    void setTicksLimit(uint64_t ticks_limit);
+    // Headless ticks wait for wall clock instead of running at max speed
+    void setRealTime(bool real_time);
+
+    uint64_t getTicksCount() const;
+    const sf::Time &getTickTime() const;
+
 protected:
     virtual void event(const sf::Event &event);
     virtual void update(const sf::Time &elapsed);
     virtual void draw(const sf::Time &elapsed);
 
+private:
+    int32_t execHeadless();
+
 private:
     bool m_running;
     sf::Time m_tick_time;
+    uint64_t m_ticks_count;
+
+    bool m_headless;
+    uint64_t m_ticks_limit;
+    bool m_real_time;
 
     sf::RenderWindow m_render_window;
 };
@@ -0,0 +1,88 @@
+#include "command_buffer.h"
+#include "world.h"
+
+namespace fck
+{
+
+thread_local CommandBuffer *CommandBuffer::m_current = nullptr;
+
+void CommandBuffer::createEntity(const std::function<void(Entity &)> &init)
+{
+    m_commands.push_back({CommandType::CREATE, Entity{}, init});
+}
+
+void CommandBuffer::destroyEntity(const Entity &entity)
+{
+    m_commands.push_back({CommandType::DESTROY, entity, nullptr});
+}
+
+void CommandBuffer::enableEntity(const Entity &entity)
+{
+    m_commands.push_back({CommandType::ENABLE, entity, nullptr});
+}
+
+void CommandBuffer::disableEntity(const Entity &entity)
+{
+    m_commands.push_back({CommandType::DISABLE, entity, nullptr});
+}
+
+void CommandBuffer::call(const std::function<void()> &function)
+{
+    m_commands.push_back({CommandType::CALL, Entity{}, [function](Entity &) { function(); }});
+}
+
+void CommandBuffer::execute(World &world)
+{
+    for (Command &command : m_commands)
+    {
+        switch (command.type)
+        {
+        case CommandType::CREATE: {
+            Entity entity = world.createEntity();
+            if (command.callback)
+                command.callback(entity);
+            break;
+        }
+        case CommandType::DESTROY:
+            world.destroyEntity(command.entity);
+            break;
+        case CommandType::ENABLE:
+            world.enableEntity(command.entity);
+            break;
+        case CommandType::DISABLE:
+            world.disableEntity(command.entity);
+            break;
+        case CommandType::CHANGE:
+            if (command.entity.isValid())
+                command.callback(command.entity);
+            break;
+        case CommandType::CALL:
+            command.callback(command.entity);
+            break;
+        }
+    }
+
+    m_commands.clear();
+}
+
+bool CommandBuffer::empty() const
+{
+    return m_commands.empty();
+}
+
+void CommandBuffer::clear()
+{
+    m_commands.clear();
+}
+
+CommandBuffer *CommandBuffer::getCurrent()
+{
+    return m_current;
+}
+
+void CommandBuffer::setCurrent(CommandBuffer *command_buffer)
+{
+    m_current = command_buffer;
+}
+
+} // namespace fck
@@ -0,0 +1,89 @@
+#ifndef COMMANDBUFFER_TMGCKXVHEQRA_H
+#define COMMANDBUFFER_TMGCKXVHEQRA_H
+
+#include "entity.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace fck
+{
+
+class World;
+
+// Records structural changes of world and applies them later on the main thread.
+// Buffer itself is not synchronized, every thread has to record into its own buffer.
+// Non-exclusive system records into its own buffer, which is current for thread updating it.
+class CommandBuffer
+{
+public:
+    CommandBuffer() = default;
+    ~CommandBuffer() = default;
+
+    void createEntity(const std::function<void(Entity &)> &init = nullptr);
+    void destroyEntity(const Entity &entity);
+    void enableEntity(const Entity &entity);
+    void disableEntity(const Entity &entity);
+
+    template<typename T, typename... Args>
+    void add(const Entity &entity, Args &&...args);
+
+    template<typename T>
+    void remove(const Entity &entity);
+
+    // Called on the main thread in order with other commands
+    void call(const std::function<void()> &function);
+
+    void execute(World &world);
+
+    bool empty() const;
+    void clear();
+
+    // Buffer of non-exclusive system updated by this thread, null otherwise
+    static CommandBuffer *getCurrent();
+    static void setCurrent(CommandBuffer *command_buffer);
+
+private:
+    enum class CommandType
+    {
+        CREATE,
+        DESTROY,
+        ENABLE,
+        DISABLE,
+        CHANGE,
+        CALL
+    };
+
+    struct Command
+    {
+        CommandType type;
+        Entity entity;
+        std::function<void(Entity &)> callback;
+    };
+
+    std::vector<Command> m_commands;
+
+    static thread_local CommandBuffer *m_current;
+};
+
+template<typename T, typename... Args>
+void CommandBuffer::add(const Entity &entity, Args &&...args)
+{
+    // Shared pointer keeps callback copyable for move only components
+    auto component = std::make_shared<T>(T{std::forward<Args>(args)...});
+    m_commands.push_back({CommandType::CHANGE, entity, [component](Entity &entity) {
+                              entity.add<T>(std::move(*component));
+                          }});
+}
+
+template<typename T>
+void CommandBuffer::remove(const Entity &entity)
+{
+    m_commands.push_back(
+        {CommandType::CHANGE, entity, [](Entity &entity) { entity.remove<T>(); }});
+}
+
+} // namespace fck
+
+#endif // COMMANDBUFFER_TMGCKXVHEQRA_H
@@ -4,25 +4,15 @@
 #include "class_type_id.h"
 
 #include <cstdint>
-#include <memory>
 
 namespace fck
 {
 
 const int32_t MAX_AMOUNT_OF_COMPONENTS = 64;
 
+// Type id family tag of components
 struct ComponentBase
 {
-    virtual ~ComponentBase() = default;
-};
-
-template<typename T>
-struct Component : public ComponentBase
-{
-    Component(T *t_data) : data{t_data}
-    {
-    }
-    std::unique_ptr<T> data;
 };
 
 template<class T>
@@ -51,7 +41,7 @@ ComponentsFilter ComponentsFilter::create()
 {
     ComponentsFilter m;
     using expander = int[];
-    (void)expander{0, (void(m.filter |= (1 << componentTypeId<Args>())), 0)...};
+    (void)expander{0, (void(m.filter |= (uint64_t(1) << componentTypeId<Args>())), 0)...};
     return m;
 }
 
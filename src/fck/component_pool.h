@@ -0,0 +1,224 @@
+#ifndef COMPONENTPOOL_WQNCXHRTPBLE_H
+#define COMPONENTPOOL_WQNCXHRTPBLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace fck
+{
+
+const uint32_t NULL_COMPONENT_INDEX = std::numeric_limits<uint32_t>::max();
+
+// Sparse set of component data. The sparse array maps entity index to dense index,
+// the dense array holds owner entity indexes in the same order as the component data.
+// Every component also keeps ticks of storage when it was added and last changed.
+class ComponentPoolBase
+{
+public:
+    ComponentPoolBase() = default;
+    virtual ~ComponentPoolBase() = default;
+
+    ComponentPoolBase(const ComponentPoolBase &) = delete;
+    ComponentPoolBase &operator=(const ComponentPoolBase &) = delete;
+
+    bool has(uint32_t index) const
+    {
+        return index < m_sparse.size() && m_sparse[index] != NULL_COMPONENT_INDEX;
+    }
+
+    uint32_t getDenseIndex(uint32_t index) const
+    {
+        return m_sparse[index];
+    }
+
+    const std::vector<uint32_t> &getEntityIndexes() const
+    {
+        return m_dense;
+    }
+
+    uint32_t size() const
+    {
+        return m_dense.size();
+    }
+
+    bool empty() const
+    {
+        return m_dense.empty();
+    }
+
+    uint32_t getAddedTick(uint32_t index) const
+    {
+        return m_added_ticks[m_sparse[index]];
+    }
+
+    uint32_t getChangedTick(uint32_t index) const
+    {
+        return m_changed_ticks[m_sparse[index]];
+    }
+
+    void markAdded(uint32_t index, uint32_t tick)
+    {
+        m_added_ticks[m_sparse[index]] = tick;
+        m_changed_ticks[m_sparse[index]] = tick;
+    }
+
+    void markChanged(uint32_t index, uint32_t tick)
+    {
+        m_changed_ticks[m_sparse[index]] = tick;
+    }
+
+    virtual void remove(uint32_t index) = 0;
+    virtual void clear() = 0;
+
+protected:
+    std::vector<uint32_t> m_sparse;
+    std::vector<uint32_t> m_dense;
+    std::vector<uint32_t> m_added_ticks;
+    std::vector<uint32_t> m_changed_ticks;
+};
+
+// Component data lives in fixed size pages, so growing the pool never relocates already
+// created components. Removing is swap-and-pop: the last component is moved into the freed slot.
+template<typename T>
+class ComponentPool : public ComponentPoolBase
+{
+public:
+    static constexpr uint32_t PAGE_SIZE = 256;
+
+    ComponentPool() = default;
+    ~ComponentPool();
+
+    template<typename... Args>
+    T &emplace(uint32_t index, Args &&...args);
+
+    void remove(uint32_t index);
+    void clear();
+
+    T &get(uint32_t index)
+    {
+        return at(m_sparse[index]);
+    }
+
+    const T &get(uint32_t index) const
+    {
+        return at(m_sparse[index]);
+    }
+
+    T *tryGet(uint32_t index)
+    {
+        return has(index) ? &at(m_sparse[index]) : nullptr;
+    }
+
+    T &at(uint32_t dense_index)
+    {
+        return *std::launder(
+            reinterpret_cast<T *>(m_pages[dense_index / PAGE_SIZE]->data) + dense_index % PAGE_SIZE);
+    }
+
+    const T &at(uint32_t dense_index) const
+    {
+        return *std::launder(reinterpret_cast<const T *>(m_pages[dense_index / PAGE_SIZE]->data)
+                             + dense_index % PAGE_SIZE);
+    }
+
+private:
+    struct Page
+    {
+        alignas(T) std::byte data[sizeof(T) * PAGE_SIZE];
+    };
+
+    T *slot(uint32_t dense_index)
+    {
+        return reinterpret_cast<T *>(m_pages[dense_index / PAGE_SIZE]->data)
+               + dense_index % PAGE_SIZE;
+    }
+
+private:
+    std::vector<std::unique_ptr<Page>> m_pages;
+};
+
+template<typename T>
+ComponentPool<T>::~ComponentPool()
+{
+    clear();
+}
+
+template<typename T>
+template<typename... Args>
+T &ComponentPool<T>::emplace(uint32_t index, Args &&...args)
+{
+    if (has(index))
+    {
+        T component{std::forward<Args>(args)...};
+        T &replaced = get(index);
+        std::destroy_at(&replaced);
+        return *::new (&replaced) T{std::move(component)};
+    }
+
+    if (index >= m_sparse.size())
+        m_sparse.resize(index + 1, NULL_COMPONENT_INDEX);
+
+    uint32_t dense_index = m_dense.size();
+    if (dense_index / PAGE_SIZE >= m_pages.size())
+        m_pages.push_back(std::make_unique<Page>());
+
+    T *component = ::new (slot(dense_index)) T{std::forward<Args>(args)...};
+
+    m_sparse[index] = dense_index;
+    m_dense.push_back(index);
+    m_added_ticks.push_back(0);
+    m_changed_ticks.push_back(0);
+
+    return *component;
+}
+
+template<typename T>
+void ComponentPool<T>::remove(uint32_t index)
+{
+    if (!has(index))
+        return;
+
+    uint32_t dense_index = m_sparse[index];
+    uint32_t last_dense_index = m_dense.size() - 1;
+
+    T &removed = at(dense_index);
+    std::destroy_at(&removed);
+
+    if (dense_index != last_dense_index)
+    {
+        T &last = at(last_dense_index);
+        ::new (&removed) T{std::move(last)};
+        std::destroy_at(&last);
+
+        m_dense[dense_index] = m_dense[last_dense_index];
+        m_sparse[m_dense[dense_index]] = dense_index;
+        m_added_ticks[dense_index] = m_added_ticks[last_dense_index];
+        m_changed_ticks[dense_index] = m_changed_ticks[last_dense_index];
+    }
+
+    m_dense.pop_back();
+    m_added_ticks.pop_back();
+    m_changed_ticks.pop_back();
+    m_sparse[index] = NULL_COMPONENT_INDEX;
+}
+
+template<typename T>
+void ComponentPool<T>::clear()
+{
+    for (uint32_t i = 0; i < m_dense.size(); ++i)
+        std::destroy_at(&at(i));
+
+    m_dense.clear();
+    m_sparse.clear();
+    m_added_ticks.clear();
+    m_changed_ticks.clear();
+}
+
+} // namespace fck
+
+#endif // COMPONENTPOOL_WQNCXHRTPBLE_H
@@ -1,113 +1,61 @@
 #include "component_storage.h"
 #include "common.h"
-#include "utilities.h"
 
 namespace fck
 {
 
-ComponentStorage::ComponentStorage(int32_t size) : m_component_entries(size)
+ComponentStorage::ComponentStorage(int32_t size) : m_components_filters(size), m_tick{1}
 {
 }
 
-void ComponentStorage::add(
-    Entity &entity, ComponentBase *component, TypeId component_type_id)
+void ComponentStorage::removeAll(uint32_t index)
 {
-    fck_assert(entity.isValid(), "invalid entity cannot have components added to it");
+    ComponentsFilter &components_filter = m_components_filters[index];
 
-    auto index = entity.getId().getIndex();
-    auto &component_data_for_entity = m_component_entries[index];
-
-    component_data_for_entity.components[component_type_id].reset(component);
-    component_data_for_entity.components_filter.filter |= (1 << component_type_id);
-}
-
-void ComponentStorage::remove(Entity &entity, TypeId component_type_id)
-{
-    if (!entity.isValid())
-        return;
-
-    auto index = entity.getId().getIndex();
-    auto &component_data_for_entity = m_component_entries[index];
-
-    component_data_for_entity.components[component_type_id].reset();
-    component_data_for_entity.components_filter.filter &= ~(1 << component_type_id);
-}
-
-void ComponentStorage::removeAll(Entity &entity)
-{
-    if (!entity.isValid())
-        return;
-
-    auto index = entity.getId().getIndex();
-    auto &component_data_for_entity = m_component_entries[index];
-
-    for (int32_t i = 0; i < MAX_AMOUNT_OF_COMPONENTS; ++i)
+    for (int32_t i = 0; components_filter.filter != 0 && i < MAX_AMOUNT_OF_COMPONENTS; ++i)
     {
-        if (component_data_for_entity.components_filter.filter & (1 << i))
+        if (components_filter.filter & (uint64_t(1) << i))
         {
-            component_data_for_entity.components[i].reset();
-            component_data_for_entity.components_filter.filter &= ~(1 << i);
+            m_pools[i]->remove(index);
+            components_filter.filter &= ~(uint64_t(1) << i);
         }
     }
 }
 
-ComponentBase *ComponentStorage::get(const Entity &entity, TypeId component_type_id) const
+ComponentsFilter ComponentStorage::getComponentsFilter(uint32_t index) const
 {
-    fck_assert(
-        entity.isValid() && has(entity, component_type_id),
-        "Entity is not valid or does not contain component");
-
-    return getComponentsArray(entity)[component_type_id].get();
+    return m_components_filters[index];
 }
 
-ComponentsFilter ComponentStorage::getComponentsFilter(const Entity &entity) const
+uint32_t ComponentStorage::getTick() const
 {
-    fck_assert(entity.isValid(), "invalid entity cannot retrieve the component list");
-
-    return m_component_entries[entity.getId().getIndex()].components_filter;
+    return m_tick;
 }
 
-std::vector<ComponentBase *> ComponentStorage::getAll(const Entity &entity) const
+uint32_t ComponentStorage::nextTick()
 {
-    fck_assert(entity.isValid(), "invalid entity cannot retrieve components, as it has none");
-
-    auto &components_array = getComponentsArray(entity);
-
-    std::vector<ComponentBase *> components_list;
-    components_list.reserve(components_array.size());
-
-    for (auto &component : components_array)
-        components_list.emplace_back(component.get());
-
-    return components_list;
+    return ++m_tick;
 }
 
-bool ComponentStorage::has(const Entity &entity, TypeId component_type_id) const
+int32_t ComponentStorage::size() const
 {
-    fck_assert(entity.isValid(), "invalid entity cannot check if it has components");
-
-    auto &components = getComponentsArray(entity);
-    return components.size() > component_type_id && components[component_type_id] != nullptr;
+    return m_components_filters.size();
 }
 
 void ComponentStorage::resize(int32_t size)
 {
-    m_component_entries.resize(size);
+    m_components_filters.resize(size);
 }
 
 void ComponentStorage::clear()
 {
-    m_component_entries.clear();
-}
-
-ComponentStorage::ComponentsArray &ComponentStorage::getComponentsArray(const Entity &e)
-{
-    return m_component_entries[e.getId().getIndex()].components;
-}
+    for (auto &pool : m_pools)
+    {
+        if (pool)
+            pool->clear();
+    }
 
-const ComponentStorage::ComponentsArray &ComponentStorage::getComponentsArray(const Entity &e) const
-{
-    return m_component_entries[e.getId().getIndex()].components;
+    m_components_filters.clear();
 }
 
 } // namespace fck
@@ -2,7 +2,12 @@
 #define COMPONENTSTORAGE_PLZCNBTEUGYS_H
 
 #include "component.h"
-#include "entity.h"
+#include "component_pool.h"
+#include "paged_vector.h"
+#include "utilities.h"
+
+#include <memory>
+#include <vector>
 
 namespace fck
 {
@@ -19,42 +24,116 @@ public:
     ComponentStorage &operator=(const ComponentStorage &) = delete;
     ComponentStorage &operator=(ComponentStorage &&) = delete;
 
-    void add(Entity &entity, ComponentBase *component, TypeId component_type_id);
-    void remove(Entity &entity, TypeId component_type_id);
-    void removeAll(Entity &entity);
+    template<typename T, typename... Args>
+    T &add(uint32_t index, Args &&...args);
+
+    template<typename T>
+    void remove(uint32_t index);
+    void removeAll(uint32_t index);
+
+    template<typename T>
+    T &get(uint32_t index) const;
+
+    template<typename T>
+    bool has(uint32_t index) const;
+
+    template<typename T>
+    void markChanged(uint32_t index);
+
+    // Tick is written to components when they are added or marked changed
+    uint32_t getTick() const;
+    uint32_t nextTick();
+
+    template<typename T>
+    ComponentPool<T> &getPool();
 
-    ComponentBase *get(const Entity &entity, TypeId component_type_id) const;
-    ComponentsFilter getComponentsFilter(const Entity &entity) const;
-    std::vector<ComponentBase *> getAll(const Entity &entity) const;
+    template<typename T>
+    ComponentPool<T> *findPool() const;
 
-    bool has(const Entity &entity, TypeId component_type_id) const;
+    ComponentsFilter getComponentsFilter(uint32_t index) const;
 
+    int32_t size() const;
     void resize(int32_t size);
     void clear();
 
 private:
-    typedef std::array<std::unique_ptr<ComponentBase>, MAX_AMOUNT_OF_COMPONENTS> ComponentsArray;
+    std::vector<std::unique_ptr<ComponentPoolBase>> m_pools;
+    PagedVector<ComponentsFilter> m_components_filters;
+    uint32_t m_tick;
+};
 
-    ComponentsArray &getComponentsArray(const Entity &e);
-    const ComponentsArray &getComponentsArray(const Entity &e) const;
+template<typename T, typename... Args>
+T &ComponentStorage::add(uint32_t index, Args &&...args)
+{
+    TypeId component_type_id = componentTypeId<T>();
 
-private:
-    struct EntityComponents
-    {
-        EntityComponents() = default;
+    ComponentPool<T> &pool = getPool<T>();
+    T &component = pool.emplace(index, std::forward<Args>(args)...);
+    pool.markAdded(index, m_tick);
+    m_components_filters[index].filter |= (uint64_t(1) << component_type_id);
 
-        EntityComponents(EntityComponents &&other)
-            : components(std::move(other.components)),
-              components_filter(std::move(other.components_filter))
-        {
-        }
+    return component;
+}
 
-        ComponentsArray components;
-        ComponentsFilter components_filter;
-    };
+template<typename T>
+void ComponentStorage::remove(uint32_t index)
+{
+    ComponentPool<T> *pool = findPool<T>();
+    if (!pool)
+        return;
 
-    std::vector<EntityComponents> m_component_entries;
-};
+    pool->remove(index);
+    m_components_filters[index].filter &= ~(uint64_t(1) << componentTypeId<T>());
+}
+
+template<typename T>
+T &ComponentStorage::get(uint32_t index) const
+{
+    ComponentPool<T> *pool = findPool<T>();
+    fck_assert(pool && pool->has(index), "Entity does not contain component");
+
+    return pool->get(index);
+}
+
+template<typename T>
+bool ComponentStorage::has(uint32_t index) const
+{
+    return m_components_filters[index].filter & (uint64_t(1) << componentTypeId<T>());
+}
+
+template<typename T>
+void ComponentStorage::markChanged(uint32_t index)
+{
+    ComponentPool<T> *pool = findPool<T>();
+    if (pool && pool->has(index))
+        pool->markChanged(index, m_tick);
+}
+
+template<typename T>
+ComponentPool<T> &ComponentStorage::getPool()
+{
+    TypeId component_type_id = componentTypeId<T>();
+    fck_assert(
+        component_type_id < MAX_AMOUNT_OF_COMPONENTS, "Maximum amount of components exceeded");
+
+    if (m_pools.size() <= component_type_id)
+        m_pools.resize(component_type_id + 1);
+
+    if (!m_pools[component_type_id])
+        m_pools[component_type_id] = std::make_unique<ComponentPool<T>>();
+
+    return static_cast<ComponentPool<T> &>(*m_pools[component_type_id]);
+}
+
+template<typename T>
+ComponentPool<T> *ComponentStorage::findPool() const
+{
+    TypeId component_type_id = componentTypeId<T>();
+    if (m_pools.size() <= component_type_id)
+        return nullptr;
+
+    return static_cast<ComponentPool<T> *>(m_pools[component_type_id].get());
+}
 
 } // namespace fck
 
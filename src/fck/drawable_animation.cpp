@@ -7,6 +7,11 @@ DrawableAnimation::DrawableAnimation()
 {
 }
 
+DrawableAnimation *DrawableAnimation::copy(DrawableProxyBase *proxy) const
+{
+    return new DrawableAnimation{};
+}
+
 void DrawableAnimation::setCurrentState(const std::string &state_name)
 {
 }
@@ -10,12 +10,17 @@
 namespace fck
 {
 
+struct DrawableProxyBase;
+
 class DrawableAnimation
 {
 public:
     DrawableAnimation();
     virtual ~DrawableAnimation() = default;
 
+    // Copy of animation that works with drawable of proxy
+    virtual DrawableAnimation *copy([[maybe_unused]] DrawableProxyBase *proxy) const;
+
     virtual void setCurrentState([[maybe_unused]] const std::string &state_name);
     virtual std::vector<std::string> getStates() const;
 
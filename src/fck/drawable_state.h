@@ -7,12 +7,17 @@
 namespace fck
 {
 
+struct DrawableProxyBase;
+
 class DrawableState
 {
 public:
     DrawableState();
     virtual ~DrawableState() = default;
 
+    // Copy of state that works with drawable of proxy
+    virtual DrawableState *copy(DrawableProxyBase *proxy) const = 0;
+
     virtual std::string getCurrentState() const = 0;
     virtual void setCurrentState(const std::string &state_name) = 0;
 
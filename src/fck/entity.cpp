@@ -65,12 +65,15 @@ void Entity::destroy()
 
 void Entity::removeAllComponents()
 {
-    getWorld()->m_entity_attributes.component_storage.removeAll(*this);
+    if (!isValid())
+        return;
+
+    getComponentStorage().removeAll(m_id.getIndex());
 }
 
 ComponentsFilter Entity::getComponentFilter() const
 {
-    return getWorld()->m_entity_attributes.component_storage.getComponentsFilter(*this);
+    return getComponentStorage().getComponentsFilter(m_id.getIndex());
 }
 
 bool Entity::operator==(const Entity &entity) const
@@ -83,25 +86,10 @@ bool Entity::operator!=(const Entity &entity) const
     return !operator==(entity);
 }
 
-void Entity::add(ComponentBase *component, TypeId component_type_id)
-{
-    getWorld()->m_entity_attributes.component_storage.add(
-        *this, component, component_type_id);
-}
-
-void Entity::remove(TypeId component_type_id)
-{
-    getWorld()->m_entity_attributes.component_storage.remove(*this, component_type_id);
-}
-
-ComponentBase *Entity::get(TypeId component_type_id) const
-{
-    return getWorld()->m_entity_attributes.component_storage.get(*this, component_type_id);
-}
-
-bool Entity::has(TypeId component_type_id) const
+ComponentStorage &Entity::getComponentStorage() const
 {
-    return getWorld()->m_entity_attributes.component_storage.has(*this, component_type_id);
+    fck_assert(isValid(), "Entity is not valid");
+    return getWorld()->m_entity_attributes.component_storage;
 }
 
 } // namespace fck
@@ -2,6 +2,7 @@
 #define ENTITY_IVVPWAPMUTXK_H
 
 #include "component.h"
+#include "component_storage.h"
 #include "id_storage.h"
 
 namespace fck
@@ -44,16 +45,21 @@ public:
     template<typename T>
     bool has() const;
 
+    // Marks component as changed at current tick of world
+    template<typename T>
+    void markChanged() const;
+
+    // Tick component was last changed at
+    template<typename T>
+    uint32_t getChangedTick() const;
+
     ComponentsFilter getComponentFilter() const;
 
     bool operator==(const Entity &entity) const;
     bool operator!=(const Entity &entity) const;
 
 private:
-    void add(ComponentBase *component, TypeId component_type_id);
-    void remove(TypeId component_type_id);
-    ComponentBase *get(TypeId component_type_id) const;
-    bool has(TypeId component_type_id) const;
+    ComponentStorage &getComponentStorage() const;
 
 private:
     Id m_id;
@@ -63,36 +69,46 @@ private:
 template<typename T, typename... Args>
 T &Entity::add(Args &&...args)
 {
-    Component<T> *c = new Component<T>{new T{std::forward<Args>(args)...}};
-    add(c, componentTypeId<T>());
-    return *(c->data.get());
+    return getComponentStorage().add<T>(m_id.getIndex(), std::forward<Args>(args)...);
 }
 
 template<typename T>
 T &Entity::add(const T &component)
 {
-    Component<T> *c = new Component<T>{new T{component}};
-    add(c, componentTypeId<T>());
-    return *(c->data.get());
+    return getComponentStorage().add<T>(m_id.getIndex(), component);
 }
 
 template<typename T>
 void Entity::remove()
 {
-    remove(componentTypeId<T>());
+    if (!isValid())
+        return;
+
+    getComponentStorage().remove<T>(m_id.getIndex());
 }
 
 template<typename T>
 T &Entity::get() const
 {
-    Component<T> *c = static_cast<Component<T> *>(get(componentTypeId<T>()));
-    return static_cast<T &>(*(c->data.get()));
+    return getComponentStorage().get<T>(m_id.getIndex());
 }
 
 template<typename T>
 bool Entity::has() const
 {
-    return has(componentTypeId<T>());
+    return getComponentStorage().has<T>(m_id.getIndex());
+}
+
+template<typename T>
+void Entity::markChanged() const
+{
+    getComponentStorage().markChanged<T>(m_id.getIndex());
+}
+
+template<typename T>
+uint32_t Entity::getChangedTick() const
+{
+    return getComponentStorage().getPool<T>().getChangedTick(m_id.getIndex());
 }
 
 } // namespace fck
@@ -1,4 +1,5 @@
 #include "event_dispatcher.h"
+#include "perf_counters.h"
 
 #include <spdlog/spdlog.h>
 
@@ -90,6 +91,8 @@ void EventDispatcher::_update(sf::Time elapsed)
     static std::queue<EventDetail> empty_event_details;
     std::swap(m_need_add_event_details, empty_event_details);
 
+    FCK_PERF_COUNTER_ADD("EventDispatcher events", m_event_details.size());
+
     while (!m_event_details.empty())
     {
         EventDetail &event_detail = m_event_details.front();
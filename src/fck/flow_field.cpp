@@ -0,0 +1,206 @@
+#include "flow_field.h"
+#include "perf_counters.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace fck
+{
+
+std::vector<sf::Vector2i> FlowField::m_directions
+    = {{0, 1}, {1, 0}, {0, -1}, {-1, 0}, {-1, -1}, {1, 1}, {-1, 1}, {1, -1}};
+
+FlowField::FlowField() : m_walls{nullptr}, m_valid{false}
+{
+}
+
+FlowField::FlowField(const Vector2D<int32_t> &walls) : FlowField{}
+{
+    setWalls(walls);
+}
+
+const Vector2D<int32_t> *FlowField::getWalls() const
+{
+    return m_walls;
+}
+
+void FlowField::setWalls(const Vector2D<int32_t> &walls)
+{
+    m_walls = &walls;
+    m_valid = false;
+}
+
+bool FlowField::isValid() const
+{
+    return m_valid;
+}
+
+const sf::Vector2i &FlowField::getTarget() const
+{
+    return m_target;
+}
+
+void FlowField::update(const sf::Vector2i &target)
+{
+    if (!m_walls || (m_valid && m_target == target))
+        return;
+
+    FCK_PROFILE_ZONE("FlowField::update");
+    FCK_PERF_COUNTER_ADD("FlowField::update builds", 1);
+
+    m_target = target;
+    m_valid = true;
+
+    m_distances.assign(m_walls->getSize(), UNREACHABLE);
+    m_next.assign(m_walls->getSize(), -1);
+
+    if (detectCollision(target))
+        return;
+
+    const int32_t width = m_walls->getSize2D().x;
+
+    // Min heap by distance, stale entries are skipped
+    auto greater = std::greater<std::pair<uint32_t, int32_t>>{};
+    m_opened.clear();
+
+    int32_t target_index = getIndex(target);
+    m_distances[target_index] = 0;
+    m_next[target_index] = target_index;
+    m_opened.push_back({0, target_index});
+
+    while (!m_opened.empty())
+    {
+        std::pop_heap(m_opened.begin(), m_opened.end(), greater);
+        auto [distance, index] = m_opened.back();
+        m_opened.pop_back();
+
+        if (distance != m_distances[index])
+            continue;
+
+        sf::Vector2i coordinates = m_walls->transformIndex(index);
+        for (int32_t i = 0; i < int32_t(m_directions.size()); ++i)
+        {
+            sf::Vector2i new_coordinates = coordinates + m_directions[i];
+            if (detectCollision(new_coordinates))
+                continue;
+
+            int32_t new_index = new_coordinates.y * width + new_coordinates.x;
+            uint32_t new_distance = distance + ((i < 4) ? 10 : 14);
+            if (new_distance < m_distances[new_index])
+            {
+                m_distances[new_index] = new_distance;
+                m_next[new_index] = index;
+                m_opened.push_back({new_distance, new_index});
+                std::push_heap(m_opened.begin(), m_opened.end(), greater);
+            }
+        }
+    }
+}
+
+uint32_t FlowField::getDistance(const sf::Vector2i &coordinates) const
+{
+    if (!m_valid || !isInside(coordinates))
+        return UNREACHABLE;
+
+    if (detectCollision(coordinates))
+    {
+        uint32_t distance = UNREACHABLE;
+        findWallExit(coordinates, distance);
+        return distance;
+    }
+
+    return m_distances[getIndex(coordinates)];
+}
+
+bool FlowField::isReachable(const sf::Vector2i &coordinates) const
+{
+    return getDistance(coordinates) != UNREACHABLE;
+}
+
+sf::Vector2i FlowField::getNext(const sf::Vector2i &coordinates) const
+{
+    if (!isReachable(coordinates))
+        return coordinates;
+
+    if (detectCollision(coordinates))
+    {
+        uint32_t distance = UNREACHABLE;
+        return m_walls->transformIndex(findWallExit(coordinates, distance));
+    }
+
+    return m_walls->transformIndex(m_next[getIndex(coordinates)]);
+}
+
+std::vector<sf::Vector2i> FlowField::getPath(const sf::Vector2i &source) const
+{
+    std::vector<sf::Vector2i> path;
+    if (!isReachable(source))
+        return path;
+
+    int32_t index = getIndex(source);
+    path.push_back(source);
+
+    if (detectCollision(source))
+    {
+        uint32_t distance = UNREACHABLE;
+        index = findWallExit(source, distance);
+        path.push_back(m_walls->transformIndex(index));
+    }
+
+    while (m_next[index] != index)
+    {
+        index = m_next[index];
+        path.push_back(m_walls->transformIndex(index));
+    }
+
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+int32_t FlowField::findWallExit(const sf::Vector2i &coordinates, uint32_t &distance) const
+{
+    int32_t exit_index = -1;
+    distance = UNREACHABLE;
+
+    for (int32_t i = 0; i < int32_t(m_directions.size()); ++i)
+    {
+        sf::Vector2i neighbor_coordinates = coordinates + m_directions[i];
+        if (detectCollision(neighbor_coordinates))
+            continue;
+
+        int32_t neighbor_index = getIndex(neighbor_coordinates);
+        if (m_distances[neighbor_index] == UNREACHABLE)
+            continue;
+
+        uint32_t neighbor_distance = m_distances[neighbor_index] + ((i < 4) ? 10 : 14);
+        if (neighbor_distance < distance)
+        {
+            distance = neighbor_distance;
+            exit_index = neighbor_index;
+        }
+    }
+
+    return exit_index;
+}
+
+bool FlowField::detectCollision(const sf::Vector2i &coordinates) const
+{
+    if (!isInside(coordinates))
+        return true;
+    return m_walls->at(getIndex(coordinates)) > 0;
+}
+
+bool FlowField::isInside(const sf::Vector2i &coordinates) const
+{
+    const sf::Vector2i &size = m_walls->getSize2D();
+    return coordinates.x >= 0 && coordinates.y >= 0 && coordinates.x < size.x
+        && coordinates.y < size.y;
+}
+
+int32_t FlowField::getIndex(const sf::Vector2i &coordinates) const
+{
+    return coordinates.y * m_walls->getSize2D().x + coordinates.x;
+}
+
+} // namespace fck
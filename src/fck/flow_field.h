@@ -0,0 +1,68 @@
+#ifndef FLOWFIELD_QMVHZRTKDPWA_H
+#define FLOWFIELD_QMVHZRTKDPWA_H
+
+#include "vector_2d.h"
+
+#include "SFML/System/Vector2.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace fck
+{
+
+// Dijkstra map over walls grid (0 - free cell, > 0 - wall) from one target cell. Every reachable
+// cell keeps next cell toward target, so many agents following same target read their next
+// step without own search. Costs and directions are same as PathFinder.
+class FlowField
+{
+public:
+    static constexpr uint32_t UNREACHABLE = UINT32_MAX;
+
+    FlowField();
+    FlowField(const Vector2D<int32_t> &walls);
+    ~FlowField() = default;
+
+    const Vector2D<int32_t> *getWalls() const;
+    void setWalls(const Vector2D<int32_t> &walls);
+
+    // Field is valid after update while walls aren't changed
+    bool isValid() const;
+    const sf::Vector2i &getTarget() const;
+
+    // Rebuilds field only if target cell is changed
+    void update(const sf::Vector2i &target);
+
+    // Wall cell (agent pushed into it) is left by free neighbor nearest to target
+    uint32_t getDistance(const sf::Vector2i &coordinates) const;
+    bool isReachable(const sf::Vector2i &coordinates) const;
+
+    // Next cell toward target, same coordinates on target or unreachable cell
+    sf::Vector2i getNext(const sf::Vector2i &coordinates) const;
+
+    // Same format as PathFinder::findPath: from target to source, both included
+    std::vector<sf::Vector2i> getPath(const sf::Vector2i &source) const;
+
+private:
+    // Free neighbor of wall cell with least distance, -1 if there isn't reachable one
+    int32_t findWallExit(const sf::Vector2i &coordinates, uint32_t &distance) const;
+    bool detectCollision(const sf::Vector2i &coordinates) const;
+    bool isInside(const sf::Vector2i &coordinates) const;
+    int32_t getIndex(const sf::Vector2i &coordinates) const;
+
+private:
+    static std::vector<sf::Vector2i> m_directions;
+
+    const Vector2D<int32_t> *m_walls;
+    bool m_valid;
+    sf::Vector2i m_target;
+
+    std::vector<uint32_t> m_distances;
+    std::vector<int32_t> m_next;
+    // Open list of build, kept to not allocate on every rebuild
+    std::vector<std::pair<uint32_t, int32_t>> m_opened;
+};
+
+} // namespace fck
+
+#endif // FLOWFIELD_QMVHZRTKDPWA_H
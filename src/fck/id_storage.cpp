@@ -1,38 +1,78 @@
 #include "id_storage.h"
+#include "snapshot.h"
 
 namespace fck
 {
 
 Id Id::invalid;
 
-IdStorage::IdStorage(int32_t size) : m_next_index{0}, m_versions(size)
+IdStorage::IdStorage(int32_t size, IdReusePolicy reuse_policy)
+    : m_next_index{0},
+      m_reuse_policy{reuse_policy},
+      m_versions(size, 1),
+      m_free_indexes_head{0},
+      m_free_indexes_count{0}
 {
 }
 
 Id IdStorage::create()
 {
     uint32_t index = 0;
-    if (!m_free_indexes.empty())
+    if (m_free_indexes_count > 0)
     {
-        index = *m_free_indexes.begin();
-        m_free_indexes.erase(m_free_indexes.begin());
+        index = popFreeIndex();
     }
     else
     {
+        // Storage is only grown, its size is capacity reserved by world
         index = m_next_index++;
-        m_versions.resize(index + 1, 1);
+        if (m_versions.size() <= index)
+            m_versions.resize(index + 1, 1);
     }
 
     return Id(index, m_versions[index]);
 }
 
+std::vector<Id> IdStorage::createMany(int32_t count)
+{
+    std::vector<Id> ids;
+    ids.reserve(count);
+
+    while (m_free_indexes_count > 0 && int32_t(ids.size()) < count)
+    {
+        uint32_t index = popFreeIndex();
+        ids.emplace_back(index, m_versions[index]);
+    }
+
+    uint32_t new_count = count - ids.size();
+    if (new_count > 0)
+    {
+        if (m_versions.size() < m_next_index + new_count)
+            m_versions.resize(m_next_index + new_count, 1);
+
+        for (uint32_t i = 0; i < new_count; ++i)
+        {
+            uint32_t index = m_next_index++;
+            ids.emplace_back(index, m_versions[index]);
+        }
+    }
+
+    return ids;
+}
+
 void IdStorage::destroy(const Id &id)
 {
     if (!isValid(id))
         return;
 
-    ++m_versions[id];
-    m_free_indexes.insert(id.getIndex());
+    ++m_versions[id.getIndex()];
+    pushFreeIndex(id.getIndex());
+}
+
+void IdStorage::destroyMany(const std::vector<Id> &ids)
+{
+    for (const Id &id : ids)
+        destroy(id);
 }
 
 Id IdStorage::get(uint32_t index) const
@@ -44,19 +84,23 @@ Id IdStorage::get(uint32_t index) const
 
 bool IdStorage::isValid(const Id &id) const
 {
-    return id.getIndex() < m_next_index && id.getVersion() == m_versions[id];
+    return id.getIndex() < m_next_index && id.getVersion() == m_versions[id.getIndex()];
 }
 
 void IdStorage::resize(int32_t size)
 {
-    m_versions.resize(size);
+    // Only grows, version of not created id is 1, so first id of index isn't null
+    if (uint32_t(size) > m_versions.size())
+        m_versions.resize(size, 1);
 }
 
 void IdStorage::clear()
 {
     m_next_index = 0;
-    m_free_indexes.clear();
     m_versions.clear();
+    m_free_indexes.clear();
+    m_free_indexes_head = 0;
+    m_free_indexes_count = 0;
 }
 
 int32_t IdStorage::size() const
@@ -64,4 +108,84 @@ int32_t IdStorage::size() const
     return m_versions.size();
 }
 
+IdReusePolicy IdStorage::getReusePolicy() const
+{
+    return m_reuse_policy;
+}
+
+void IdStorage::setReusePolicy(IdReusePolicy reuse_policy)
+{
+    m_reuse_policy = reuse_policy;
+}
+
+void IdStorage::save(SnapshotWriter &writer) const
+{
+    writer.write(m_next_index);
+
+    writer.write(m_versions.size());
+    for (uint32_t i = 0; i < m_versions.size(); ++i)
+        writer.write(m_versions[i]);
+
+    // Free indexes are written unwrapped, from head of ring buffer
+    writer.write(m_free_indexes_count);
+    for (uint32_t i = 0; i < m_free_indexes_count; ++i)
+        writer.write(m_free_indexes[(m_free_indexes_head + i) % m_free_indexes.size()]);
+}
+
+void IdStorage::restore(SnapshotReader &reader)
+{
+    clear();
+
+    m_next_index = reader.read<uint32_t>();
+
+    uint32_t versions_size = reader.read<uint32_t>();
+    fck_assert(m_next_index <= versions_size, "Invalid snapshot ids");
+
+    m_versions.resize(versions_size);
+    for (uint32_t i = 0; i < versions_size; ++i)
+        m_versions[i] = reader.read<uint32_t>();
+
+    m_free_indexes_count = reader.read<uint32_t>();
+    fck_assert(m_free_indexes_count <= versions_size, "Invalid snapshot free ids");
+
+    m_free_indexes.resize(std::max<std::size_t>(16, m_free_indexes_count));
+    for (uint32_t i = 0; i < m_free_indexes_count; ++i)
+        m_free_indexes[i] = reader.read<uint32_t>();
+}
+
+void IdStorage::pushFreeIndex(uint32_t index)
+{
+    if (m_free_indexes_count == m_free_indexes.size())
+    {
+        // Grow ring buffer and unwrap it to start from zero
+        std::vector<uint32_t> free_indexes(std::max<std::size_t>(16, m_free_indexes.size() * 2));
+        for (uint32_t i = 0; i < m_free_indexes_count; ++i)
+            free_indexes[i] = m_free_indexes[(m_free_indexes_head + i) % m_free_indexes.size()];
+
+        m_free_indexes.swap(free_indexes);
+        m_free_indexes_head = 0;
+    }
+
+    m_free_indexes[(m_free_indexes_head + m_free_indexes_count) % m_free_indexes.size()] = index;
+    ++m_free_indexes_count;
+}
+
+uint32_t IdStorage::popFreeIndex()
+{
+    uint32_t index = 0;
+    if (m_reuse_policy == IdReusePolicy::FIFO)
+    {
+        index = m_free_indexes[m_free_indexes_head];
+        m_free_indexes_head = (m_free_indexes_head + 1) % m_free_indexes.size();
+    }
+    else
+    {
+        index = m_free_indexes
+            [(m_free_indexes_head + m_free_indexes_count - 1) % m_free_indexes.size()];
+    }
+
+    --m_free_indexes_count;
+    return index;
+}
+
 } // namespace fck
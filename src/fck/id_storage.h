@@ -1,6 +1,8 @@
 #ifndef IDSTORAGE_QANJPHGWHNHN_H
 #define IDSTORAGE_QANJPHGWHNHN_H
 
+#include "paged_vector.h"
+
 #include <spdlog/spdlog.h>
 
 #include <stdint.h>
@@ -8,12 +10,14 @@
 #include <functional>
 #include <limits>
 #include <memory>
-#include <set>
 #include <vector>
 
 namespace fck
 {
 
+class SnapshotWriter;
+class SnapshotReader;
+
 struct Id
 {
     static Id invalid;
@@ -79,24 +83,49 @@ private:
     uint64_t m_id;
 };
 
+// Order of reusing indexes of destroyed ids
+enum class IdReusePolicy
+{
+    LIFO, // last destroyed index is reused first, keeps hot indexes in cache
+    FIFO // oldest destroyed index is reused first, versions of an index grow slower
+};
+
 class IdStorage
 {
 public:
-    IdStorage(int32_t size = 0);
+    IdStorage(int32_t size = 0, IdReusePolicy reuse_policy = IdReusePolicy::LIFO);
     virtual ~IdStorage() = default;
 
     Id create();
+    std::vector<Id> createMany(int32_t count);
     void destroy(const Id &id);
+    void destroyMany(const std::vector<Id> &ids);
     Id get(uint32_t index) const;
     bool isValid(const Id &id) const;
     void resize(int32_t size);
     void clear();
     int32_t size() const;
 
+    IdReusePolicy getReusePolicy() const;
+    void setReusePolicy(IdReusePolicy reuse_policy);
+
+    // Versions and free indexes, reuse policy is not part of snapshot
+    void save(SnapshotWriter &writer) const;
+    void restore(SnapshotReader &reader);
+
+private:
+    void pushFreeIndex(uint32_t index);
+    uint32_t popFreeIndex();
+
 private:
     uint32_t m_next_index;
-    std::set<uint32_t> m_free_indexes;
-    std::vector<uint32_t> m_versions;
+    IdReusePolicy m_reuse_policy;
+    PagedVector<uint32_t> m_versions;
+
+    // Ring buffer of free indexes
+    std::vector<uint32_t> m_free_indexes;
+    uint32_t m_free_indexes_head;
+    uint32_t m_free_indexes_count;
 };
 
 } // namespace fck
@@ -0,0 +1,423 @@
+#include "incremental_path_finder.h"
+#include "perf_counters.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace fck
+{
+
+namespace
+{
+
+// Octagonal distance, consistent for costs of straight and diagonal steps
+uint32_t heuristic(const sf::Vector2i &source, const sf::Vector2i &target)
+{
+    int32_t dx = std::abs(source.x - target.x);
+    int32_t dy = std::abs(source.y - target.y);
+    return 10 * (dx + dy) - 6 * std::min(dx, dy);
+}
+
+} // namespace
+
+std::vector<sf::Vector2i> IncrementalPathFinder::m_directions
+    = {{0, 1}, {1, 0}, {0, -1}, {-1, 0}, {-1, -1}, {1, 1}, {-1, 1}, {1, -1}};
+
+bool IncrementalPathFinder::Key::operator<(const Key &other) const
+{
+    if (first == other.first)
+        return second < other.second;
+    return first < other.first;
+}
+
+IncrementalPathFinder::IncrementalPathFinder()
+    : m_walls{nullptr},
+      m_nodes_limit{0},
+      m_initialized{false},
+      m_source_index{-1},
+      m_target_index{-1},
+      m_key_modifier{0},
+      m_expanded_count{0},
+      m_nodes_limit_reached{false}
+{
+}
+
+IncrementalPathFinder::IncrementalPathFinder(const Vector2D<int32_t> &walls)
+    : IncrementalPathFinder{}
+{
+    setWalls(walls);
+}
+
+const Vector2D<int32_t> *IncrementalPathFinder::getWalls() const
+{
+    return m_walls;
+}
+
+void IncrementalPathFinder::setWalls(const Vector2D<int32_t> &walls)
+{
+    m_walls = &walls;
+    reset();
+}
+
+void IncrementalPathFinder::updateWall(const sf::Vector2i &coordinates)
+{
+    if (!m_initialized || !isInside(coordinates))
+        return;
+
+    // Costs of edges to neighbors are changed too
+    updateNode(getIndex(coordinates));
+    for (const sf::Vector2i &direction : m_directions)
+    {
+        sf::Vector2i neighbor_coordinates = coordinates + direction;
+        if (isInside(neighbor_coordinates))
+            updateNode(getIndex(neighbor_coordinates));
+    }
+}
+
+void IncrementalPathFinder::reset()
+{
+    m_initialized = false;
+}
+
+int32_t IncrementalPathFinder::getNodesLimit() const
+{
+    return m_nodes_limit;
+}
+
+void IncrementalPathFinder::setNodesLimit(int32_t nodes_limit)
+{
+    m_nodes_limit = nodes_limit;
+}
+
+std::vector<sf::Vector2i> IncrementalPathFinder::findPath(
+    const sf::Vector2i &source, const sf::Vector2i &target)
+{
+    FCK_PERF_COUNTER_ADD("IncrementalPathFinder::findPath calls", 1);
+
+    m_expanded_count = 0;
+    m_nodes_limit_reached = false;
+
+    // Source can be wall cell if agent was pushed into it, it's passable while it's source
+    if (!m_walls || !isInside(source) || !isInside(target) || (*m_walls)[getIndex(target)] > 0)
+        return {};
+
+    if (!m_initialized)
+        initialize(source, target);
+
+    if (source != m_source)
+        moveSource(source);
+
+    if (target != m_target)
+        moveTarget(target);
+
+    bool found = computePath();
+
+    FCK_PERF_COUNTER_ADD("IncrementalPathFinder::findPath expanded nodes", m_expanded_count);
+
+    std::vector<sf::Vector2i> path;
+    if (!found)
+        return path;
+
+    // From target by neighbors with least cost from source
+    int32_t index = m_target_index;
+    path.push_back(m_target);
+
+    while (index != m_source_index)
+    {
+        sf::Vector2i coordinates = m_walls->transformIndex(index);
+        int32_t next_index = -1;
+        uint32_t next_cost = INFINITY_COST;
+
+        for (int32_t i = 0; i < int32_t(m_directions.size()); ++i)
+        {
+            sf::Vector2i neighbor_coordinates = coordinates + m_directions[i];
+            if (detectCollision(neighbor_coordinates))
+                continue;
+
+            int32_t neighbor_index = getIndex(neighbor_coordinates);
+            uint32_t cost = addCost(m_nodes[neighbor_index].g, (i < 4) ? 10 : 14);
+            if (cost < next_cost)
+            {
+                next_cost = cost;
+                next_index = neighbor_index;
+            }
+        }
+
+        // Tree is broken, next search starts from scratch
+        if (next_index == -1 || path.size() > m_nodes.size())
+        {
+            reset();
+            return {};
+        }
+
+        index = next_index;
+        path.push_back(m_walls->transformIndex(index));
+    }
+
+    return path;
+}
+
+int32_t IncrementalPathFinder::getExpandedCount() const
+{
+    return m_expanded_count;
+}
+
+bool IncrementalPathFinder::isNodesLimitReached() const
+{
+    return m_nodes_limit_reached;
+}
+
+void IncrementalPathFinder::initialize(const sf::Vector2i &source, const sf::Vector2i &target)
+{
+    m_initialized = true;
+
+    m_nodes.assign(m_walls->getSize(), Node{INFINITY_COST, INFINITY_COST, {0, 0}, -1});
+    m_opened.clear();
+
+    m_source = source;
+    m_target = target;
+    m_source_index = getIndex(source);
+    m_target_index = getIndex(target);
+    m_key_modifier = 0;
+
+    m_nodes[m_source_index].rhs = 0;
+    m_nodes[m_source_index].key = calculateKey(m_source_index);
+    pushOpened(m_source_index);
+}
+
+void IncrementalPathFinder::moveSource(const sf::Vector2i &source)
+{
+    int32_t source_index = getIndex(source);
+    const Node &source_node = m_nodes[source_index];
+
+    // New source is out of tree, search from scratch is cheaper
+    if (source_node.g == INFINITY_COST || source_node.g != source_node.rhs)
+    {
+        initialize(source, m_target);
+        return;
+    }
+
+    // New source keeps its cost as root, so costs of its subtree stay valid. States which
+    // depended on old source are updated by search.
+    int32_t old_source_index = m_source_index;
+    m_source = source;
+    m_source_index = source_index;
+    updateNode(old_source_index);
+}
+
+void IncrementalPathFinder::moveTarget(const sf::Vector2i &target)
+{
+    m_key_modifier = addCost(m_key_modifier, heuristic(m_target, target));
+    m_target = target;
+    m_target_index = getIndex(target);
+}
+
+bool IncrementalPathFinder::computePath()
+{
+    while (!m_opened.empty())
+    {
+        const Node &target_node = m_nodes[m_target_index];
+        if (!(m_nodes[m_opened.front()].key < calculateKey(m_target_index))
+            && target_node.rhs == target_node.g)
+            break;
+
+        if (m_nodes_limit > 0 && m_expanded_count >= m_nodes_limit)
+        {
+            m_nodes_limit_reached = true;
+            return false;
+        }
+
+        ++m_expanded_count;
+
+        int32_t index = m_opened.front();
+        Node &node = m_nodes[index];
+
+        Key new_key = calculateKey(index);
+        if (node.key < new_key)
+        {
+            node.key = new_key;
+            siftDown(0);
+            continue;
+        }
+
+        sf::Vector2i coordinates = m_walls->transformIndex(index);
+
+        if (node.g > node.rhs)
+        {
+            node.g = node.rhs;
+            removeOpened(index);
+        }
+        else
+        {
+            node.g = INFINITY_COST;
+            updateNode(index);
+        }
+
+        for (const sf::Vector2i &direction : m_directions)
+        {
+            sf::Vector2i neighbor_coordinates = coordinates + direction;
+            if (!detectCollision(neighbor_coordinates))
+                updateNode(getIndex(neighbor_coordinates));
+        }
+    }
+
+    const Node &target_node = m_nodes[m_target_index];
+    return target_node.g != INFINITY_COST && target_node.g == target_node.rhs;
+}
+
+void IncrementalPathFinder::updateNode(int32_t index)
+{
+    Node &node = m_nodes[index];
+
+    if (index != m_source_index)
+        node.rhs = findMinRhs(index);
+
+    if (node.g != node.rhs)
+    {
+        node.key = calculateKey(index);
+        if (node.heap_index == -1)
+        {
+            pushOpened(index);
+        }
+        else
+        {
+            siftUp(node.heap_index);
+            siftDown(node.heap_index);
+        }
+    }
+    else if (node.heap_index != -1)
+    {
+        removeOpened(index);
+    }
+}
+
+IncrementalPathFinder::Key IncrementalPathFinder::calculateKey(int32_t index) const
+{
+    const Node &node = m_nodes[index];
+    uint32_t cost = std::min(node.g, node.rhs);
+    return {
+        addCost(addCost(cost, heuristic(m_walls->transformIndex(index), m_target)),
+                m_key_modifier),
+        cost};
+}
+
+uint32_t IncrementalPathFinder::findMinRhs(int32_t index) const
+{
+    sf::Vector2i coordinates = m_walls->transformIndex(index);
+    if (detectCollision(coordinates))
+        return INFINITY_COST;
+
+    uint32_t min_rhs = INFINITY_COST;
+    for (int32_t i = 0; i < int32_t(m_directions.size()); ++i)
+    {
+        sf::Vector2i neighbor_coordinates = coordinates + m_directions[i];
+        if (detectCollision(neighbor_coordinates))
+            continue;
+
+        min_rhs = std::min(
+            min_rhs, addCost(m_nodes[getIndex(neighbor_coordinates)].g, (i < 4) ? 10 : 14));
+    }
+
+    return min_rhs;
+}
+
+bool IncrementalPathFinder::detectCollision(const sf::Vector2i &coordinates) const
+{
+    if (!isInside(coordinates))
+        return true;
+
+    int32_t index = getIndex(coordinates);
+    return (*m_walls)[index] > 0 && index != m_source_index;
+}
+
+bool IncrementalPathFinder::isInside(const sf::Vector2i &coordinates) const
+{
+    const sf::Vector2i &size = m_walls->getSize2D();
+    return coordinates.x >= 0 && coordinates.y >= 0 && coordinates.x < size.x
+        && coordinates.y < size.y;
+}
+
+int32_t IncrementalPathFinder::getIndex(const sf::Vector2i &coordinates) const
+{
+    return coordinates.y * m_walls->getSize2D().x + coordinates.x;
+}
+
+uint32_t IncrementalPathFinder::addCost(uint32_t cost, uint32_t step_cost)
+{
+    if (cost >= INFINITY_COST - step_cost)
+        return INFINITY_COST;
+    return cost + step_cost;
+}
+
+void IncrementalPathFinder::pushOpened(int32_t index)
+{
+    m_nodes[index].heap_index = int32_t(m_opened.size());
+    m_opened.push_back(index);
+    siftUp(int32_t(m_opened.size()) - 1);
+}
+
+void IncrementalPathFinder::removeOpened(int32_t index)
+{
+    int32_t heap_index = m_nodes[index].heap_index;
+    m_nodes[index].heap_index = -1;
+
+    int32_t last_index = m_opened.back();
+    m_opened.pop_back();
+
+    if (heap_index == int32_t(m_opened.size()))
+        return;
+
+    m_opened[heap_index] = last_index;
+    m_nodes[last_index].heap_index = heap_index;
+    siftUp(heap_index);
+    siftDown(m_nodes[last_index].heap_index);
+}
+
+void IncrementalPathFinder::siftUp(int32_t heap_index)
+{
+    int32_t index = m_opened[heap_index];
+    while (heap_index > 0)
+    {
+        int32_t parent_heap_index = (heap_index - 1) / 2;
+        int32_t parent_index = m_opened[parent_heap_index];
+        if (!(m_nodes[index].key < m_nodes[parent_index].key))
+            break;
+
+        m_opened[heap_index] = parent_index;
+        m_nodes[parent_index].heap_index = heap_index;
+        heap_index = parent_heap_index;
+    }
+
+    m_opened[heap_index] = index;
+    m_nodes[index].heap_index = heap_index;
+}
+
+void IncrementalPathFinder::siftDown(int32_t heap_index)
+{
+    int32_t size = int32_t(m_opened.size());
+    int32_t index = m_opened[heap_index];
+    while (true)
+    {
+        int32_t child_heap_index = heap_index * 2 + 1;
+        if (child_heap_index >= size)
+            break;
+
+        if (child_heap_index + 1 < size
+            && m_nodes[m_opened[child_heap_index + 1]].key
+                < m_nodes[m_opened[child_heap_index]].key)
+            ++child_heap_index;
+
+        int32_t child_index = m_opened[child_heap_index];
+        if (!(m_nodes[child_index].key < m_nodes[index].key))
+            break;
+
+        m_opened[heap_index] = child_index;
+        m_nodes[child_index].heap_index = heap_index;
+        heap_index = child_heap_index;
+    }
+
+    m_opened[heap_index] = index;
+    m_nodes[index].heap_index = heap_index;
+}
+
+} // namespace fck
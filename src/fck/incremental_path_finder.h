@@ -0,0 +1,110 @@
+#ifndef INCREMENTALPATHFINDER_JWQTBMRXAHCZ_H
+#define INCREMENTALPATHFINDER_JWQTBMRXAHCZ_H
+
+#include "vector_2d.h"
+
+#include <SFML/System/Vector2.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace fck
+{
+
+// Moving target D* Lite (basic MT-D* Lite) over walls grid (0 - free cell, > 0 - wall).
+// Search goes from source to target and its tree is kept between calls. When target moves,
+// keys are corrected by heuristic of move. When source moves inside tree, new source becomes
+// root and only states which depended on old root are updated. Costs and directions are same
+// as PathFinder.
+class IncrementalPathFinder
+{
+public:
+    IncrementalPathFinder();
+    IncrementalPathFinder(const Vector2D<int32_t> &walls);
+    ~IncrementalPathFinder() = default;
+
+    const Vector2D<int32_t> *getWalls() const;
+    // Resets search
+    void setWalls(const Vector2D<int32_t> &walls);
+    // Cell of walls is changed
+    void updateWall(const sf::Vector2i &coordinates);
+
+    // Next search starts from scratch
+    void reset();
+
+    // Search stopped by limit is continued by next call, 0 - no limit
+    int32_t getNodesLimit() const;
+    void setNodesLimit(int32_t nodes_limit);
+
+    // Same format as PathFinder::findPath: from target to source, both included.
+    // Empty if target isn't reachable or nodes limit is reached
+    std::vector<sf::Vector2i> findPath(const sf::Vector2i &source, const sf::Vector2i &target);
+
+    // Of last search
+    int32_t getExpandedCount() const;
+    bool isNodesLimitReached() const;
+
+private:
+    struct Key
+    {
+        uint32_t first;
+        uint32_t second;
+
+        bool operator<(const Key &other) const;
+    };
+
+    struct Node
+    {
+        uint32_t g;
+        uint32_t rhs;
+        Key key;
+        // Index in open heap, -1 if node isn't opened
+        int32_t heap_index;
+    };
+
+    static constexpr uint32_t INFINITY_COST = UINT32_MAX;
+
+    void initialize(const sf::Vector2i &source, const sf::Vector2i &target);
+    void moveSource(const sf::Vector2i &source);
+    void moveTarget(const sf::Vector2i &target);
+    bool computePath();
+
+    void updateNode(int32_t index);
+    Key calculateKey(int32_t index) const;
+    uint32_t findMinRhs(int32_t index) const;
+
+    // Source cell isn't collision even if it's wall
+    bool detectCollision(const sf::Vector2i &coordinates) const;
+    bool isInside(const sf::Vector2i &coordinates) const;
+    int32_t getIndex(const sf::Vector2i &coordinates) const;
+    static uint32_t addCost(uint32_t cost, uint32_t step_cost);
+
+    void pushOpened(int32_t index);
+    void removeOpened(int32_t index);
+    void siftUp(int32_t heap_index);
+    void siftDown(int32_t heap_index);
+
+private:
+    static std::vector<sf::Vector2i> m_directions;
+
+    const Vector2D<int32_t> *m_walls;
+    int32_t m_nodes_limit;
+
+    bool m_initialized;
+    sf::Vector2i m_source;
+    sf::Vector2i m_target;
+    int32_t m_source_index;
+    int32_t m_target_index;
+    // Sum of heuristics of target moves
+    uint32_t m_key_modifier;
+
+    std::vector<Node> m_nodes;
+    std::vector<int32_t> m_opened;
+
+    int32_t m_expanded_count;
+    bool m_nodes_limit_reached;
+};
+
+} // namespace fck
+
+#endif // INCREMENTALPATHFINDER_JWQTBMRXAHCZ_H
@@ -0,0 +1,227 @@
+#ifndef INLINESIGNAL_QMTVZREKDAWS_H
+#define INLINESIGNAL_QMTVZREKDAWS_H
+
+#include "utilities.h"
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fck
+{
+
+// Signal for use from one thread: emission takes no lock and does not copy slots.
+// Small trivially copyable callables (member function with object, lambdas capturing a few
+// pointers) are kept inside slot, first slots are kept inside signal itself.
+// Slots must not connect to or disconnect from the signal they are called by.
+template<typename... Args>
+class InlineSignal
+{
+public:
+    InlineSignal();
+    ~InlineSignal() = default;
+
+    InlineSignal(const InlineSignal &) = delete;
+    InlineSignal(InlineSignal &&) = delete;
+    InlineSignal &operator=(const InlineSignal &) = delete;
+    InlineSignal &operator=(InlineSignal &&) = delete;
+
+    template<typename Callable>
+    void connect(Callable &&callable);
+
+    template<typename Object, typename Pmf>
+    void connect(Pmf pmf, Object *object);
+
+    void disconnectAll();
+
+    std::size_t getSlotCount() const;
+
+    void operator()(Args... args);
+
+private:
+    class Slot
+    {
+    public:
+        static constexpr std::size_t BUFFER_SIZE = 4 * sizeof(void *);
+
+        Slot();
+        template<typename Callable>
+        explicit Slot(Callable &&callable);
+        ~Slot();
+
+        Slot(const Slot &) = delete;
+        Slot(Slot &&other) noexcept;
+        Slot &operator=(const Slot &) = delete;
+        Slot &operator=(Slot &&other) noexcept;
+
+        void operator()(Args... args);
+
+    private:
+        void reset();
+
+    private:
+        alignas(std::max_align_t) unsigned char m_buffer[BUFFER_SIZE];
+        void (*m_invoke)(void *, Args...);
+        void (*m_destroy)(void *);
+    };
+
+    static constexpr std::size_t INLINE_SLOTS_COUNT = 4;
+
+    Slot &getSlot(std::size_t index);
+
+private:
+    Slot m_inline_slots[INLINE_SLOTS_COUNT];
+    std::vector<Slot> m_slots;
+    std::size_t m_slot_count;
+    int32_t m_emitting;
+};
+
+template<typename... Args>
+InlineSignal<Args...>::InlineSignal() : m_slot_count{0}, m_emitting{0}
+{
+}
+
+template<typename... Args>
+template<typename Callable>
+void InlineSignal<Args...>::connect(Callable &&callable)
+{
+    fck_assert(m_emitting == 0, "Connect to signal while it is emitted");
+
+    if (m_slot_count < INLINE_SLOTS_COUNT)
+        m_inline_slots[m_slot_count] = Slot{std::forward<Callable>(callable)};
+    else
+        m_slots.emplace_back(std::forward<Callable>(callable));
+
+    ++m_slot_count;
+}
+
+template<typename... Args>
+template<typename Object, typename Pmf>
+void InlineSignal<Args...>::connect(Pmf pmf, Object *object)
+{
+    connect([pmf, object](Args... args) { (object->*pmf)(args...); });
+}
+
+template<typename... Args>
+void InlineSignal<Args...>::disconnectAll()
+{
+    fck_assert(m_emitting == 0, "Disconnect from signal while it is emitted");
+
+    for (std::size_t i = 0; i < INLINE_SLOTS_COUNT; ++i)
+        m_inline_slots[i] = Slot{};
+    m_slots.clear();
+    m_slot_count = 0;
+}
+
+template<typename... Args>
+std::size_t InlineSignal<Args...>::getSlotCount() const
+{
+    return m_slot_count;
+}
+
+template<typename... Args>
+void InlineSignal<Args...>::operator()(Args... args)
+{
+    ++m_emitting;
+    for (std::size_t i = 0; i < m_slot_count; ++i)
+        getSlot(i)(args...);
+    --m_emitting;
+}
+
+template<typename... Args>
+typename InlineSignal<Args...>::Slot &InlineSignal<Args...>::getSlot(std::size_t index)
+{
+    return index < INLINE_SLOTS_COUNT ? m_inline_slots[index]
+                                      : m_slots[index - INLINE_SLOTS_COUNT];
+}
+
+template<typename... Args>
+InlineSignal<Args...>::Slot::Slot() : m_invoke{nullptr}, m_destroy{nullptr}
+{
+}
+
+template<typename... Args>
+template<typename Callable>
+InlineSignal<Args...>::Slot::Slot(Callable &&callable) : m_destroy{nullptr}
+{
+    using F = std::decay_t<Callable>;
+
+    if constexpr (
+        std::is_trivially_copyable_v<F> && sizeof(F) <= BUFFER_SIZE
+        && alignof(F) <= alignof(std::max_align_t))
+    {
+        new (m_buffer) F(std::forward<Callable>(callable));
+        m_invoke = [](void *buffer, Args... args) { (*static_cast<F *>(buffer))(args...); };
+    }
+    else
+    {
+        // Callable does not fit, buffer keeps pointer to it
+        F *heap_callable = new F(std::forward<Callable>(callable));
+        std::memcpy(m_buffer, &heap_callable, sizeof(F *));
+        m_invoke = [](void *buffer, Args... args) {
+            F *heap_callable;
+            std::memcpy(&heap_callable, buffer, sizeof(F *));
+            (*heap_callable)(args...);
+        };
+        m_destroy = [](void *buffer) {
+            F *heap_callable;
+            std::memcpy(&heap_callable, buffer, sizeof(F *));
+            delete heap_callable;
+        };
+    }
+}
+
+template<typename... Args>
+InlineSignal<Args...>::Slot::~Slot()
+{
+    reset();
+}
+
+template<typename... Args>
+InlineSignal<Args...>::Slot::Slot(Slot &&other) noexcept
+    : m_invoke{other.m_invoke}, m_destroy{other.m_destroy}
+{
+    std::memcpy(m_buffer, other.m_buffer, BUFFER_SIZE);
+    other.m_invoke = nullptr;
+    other.m_destroy = nullptr;
+}
+
+template<typename... Args>
+typename InlineSignal<Args...>::Slot &InlineSignal<Args...>::Slot::operator=(Slot &&other) noexcept
+{
+    if (this != &other)
+    {
+        reset();
+
+        std::memcpy(m_buffer, other.m_buffer, BUFFER_SIZE);
+        m_invoke = other.m_invoke;
+        m_destroy = other.m_destroy;
+        other.m_invoke = nullptr;
+        other.m_destroy = nullptr;
+    }
+
+    return *this;
+}
+
+template<typename... Args>
+void InlineSignal<Args...>::Slot::operator()(Args... args)
+{
+    m_invoke(m_buffer, args...);
+}
+
+template<typename... Args>
+void InlineSignal<Args...>::Slot::reset()
+{
+    if (m_destroy)
+        m_destroy(m_buffer);
+
+    m_invoke = nullptr;
+    m_destroy = nullptr;
+}
+
+} // namespace fck
+
+#endif // INLINESIGNAL_QMTVZREKDAWS_H
@@ -0,0 +1,305 @@
+#ifndef INPUTREPLAY_NRKDYWQOTMZF_H
+#define INPUTREPLAY_NRKDYWQOTMZF_H
+
+#include "../sigslot/signal.hpp"
+#include "snapshot.h"
+#include "utilities.h"
+
+#include <spdlog/spdlog.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace fck
+{
+
+// Records actions of input per tick and plays them back. Actions pass through replay:
+// when recording they are forwarded at once and stored with tick of next update,
+// when playing live actions are ignored and stored ones are emitted by update.
+// Together with random seed recorded session repeats exactly.
+template<typename T>
+class InputReplay
+{
+public:
+    enum Mode
+    {
+        NONE,
+        RECORDING,
+        PLAYING
+    };
+
+    struct Record
+    {
+        uint32_t tick;
+        T action;
+        bool activated;
+    };
+
+    InputReplay();
+    ~InputReplay() = default;
+
+    Mode getMode() const;
+
+    uint32_t getSeed() const;
+    uint32_t getTick() const;
+    uint32_t getTicksCount() const;
+
+    // Playing session has emitted all its ticks
+    bool isFinished() const;
+
+    void startRecording(uint32_t seed);
+    void startPlaying();
+    void stop();
+
+    // Emits actions of current tick when playing, then goes to next tick
+    void update();
+
+    // Varint coded file: magic, version, seed, ticks count and records with tick delta
+    bool saveToFile(const std::string &file_name) const;
+    bool loadFromFile(const std::string &file_name);
+
+public: // slots
+    void onActionActivated(T action);
+    void onActionDiactivated(T action);
+
+public:
+    sigslot::signal<T> action_activated;
+    sigslot::signal<T> action_diactivated;
+
+private:
+    static constexpr uint32_t MAGIC = 0x52434b46; // FCKR
+    static constexpr uint32_t VERSION = 1;
+
+    static void writeVarint(SnapshotWriter &writer, uint64_t value);
+    static uint64_t readVarint(SnapshotReader &reader);
+
+private:
+    Mode m_mode;
+    uint32_t m_seed;
+    uint32_t m_tick;
+    uint32_t m_ticks_count;
+
+    std::vector<Record> m_records;
+    std::size_t m_play_index;
+};
+
+template<typename T>
+InputReplay<T>::InputReplay()
+    : m_mode{NONE}, m_seed{0}, m_tick{0}, m_ticks_count{0}, m_play_index{0}
+{
+}
+
+template<typename T>
+typename InputReplay<T>::Mode InputReplay<T>::getMode() const
+{
+    return m_mode;
+}
+
+template<typename T>
+uint32_t InputReplay<T>::getSeed() const
+{
+    return m_seed;
+}
+
+template<typename T>
+uint32_t InputReplay<T>::getTick() const
+{
+    return m_tick;
+}
+
+template<typename T>
+uint32_t InputReplay<T>::getTicksCount() const
+{
+    return m_ticks_count;
+}
+
+template<typename T>
+bool InputReplay<T>::isFinished() const
+{
+    return m_mode == PLAYING && m_tick >= m_ticks_count;
+}
+
+template<typename T>
+void InputReplay<T>::startRecording(uint32_t seed)
+{
+    m_mode = RECORDING;
+    m_seed = seed;
+    m_tick = 0;
+    m_ticks_count = 0;
+    m_records.clear();
+    m_play_index = 0;
+}
+
+template<typename T>
+void InputReplay<T>::startPlaying()
+{
+    m_mode = PLAYING;
+    m_tick = 0;
+    m_play_index = 0;
+}
+
+template<typename T>
+void InputReplay<T>::stop()
+{
+    if (m_mode == RECORDING)
+        m_ticks_count = m_tick;
+
+    m_mode = NONE;
+}
+
+template<typename T>
+void InputReplay<T>::update()
+{
+    if (m_mode == PLAYING)
+    {
+        while (m_play_index < m_records.size() && m_records[m_play_index].tick == m_tick)
+        {
+            const Record &record = m_records[m_play_index++];
+            if (record.activated)
+                action_activated(record.action);
+            else
+                action_diactivated(record.action);
+        }
+    }
+
+    ++m_tick;
+}
+
+template<typename T>
+bool InputReplay<T>::saveToFile(const std::string &file_name) const
+{
+    std::vector<char> data;
+    SnapshotWriter writer{data};
+
+    writer.write(MAGIC);
+    writer.write(VERSION);
+    writer.write(m_seed);
+    writeVarint(writer, m_mode == RECORDING ? m_tick : m_ticks_count);
+    writeVarint(writer, m_records.size());
+
+    uint32_t tick = 0;
+    for (const Record &record : m_records)
+    {
+        writeVarint(writer, record.tick - tick);
+        writeVarint(writer, (uint64_t(record.action) << 1) | uint64_t(record.activated));
+        tick = record.tick;
+    }
+
+    std::ofstream file{file_name, std::ios::binary};
+    if (!file.is_open())
+    {
+        spdlog::warn("Can't open file to save input replay: {}", file_name);
+        return false;
+    }
+
+    file.write(data.data(), data.size());
+
+    spdlog::info("Input replay saved: {}, {} records", file_name, m_records.size());
+    return true;
+}
+
+template<typename T>
+bool InputReplay<T>::loadFromFile(const std::string &file_name)
+{
+    std::ifstream file{file_name, std::ios::binary};
+    if (!file.is_open())
+    {
+        spdlog::warn("Can't open input replay file: {}", file_name);
+        return false;
+    }
+
+    std::vector<char> data{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    SnapshotReader reader{data, nullptr};
+
+    try
+    {
+        fck_assert(reader.read<uint32_t>() == MAGIC, "File is not an input replay");
+        fck_assert(reader.read<uint32_t>() == VERSION, "Unsupported input replay version");
+
+        uint32_t seed = reader.read<uint32_t>();
+        uint32_t ticks_count = readVarint(reader);
+        uint64_t records_count = readVarint(reader);
+
+        std::vector<Record> records;
+        records.reserve(records_count);
+
+        uint32_t tick = 0;
+        for (uint64_t i = 0; i < records_count; ++i)
+        {
+            tick += readVarint(reader);
+            uint64_t action = readVarint(reader);
+            records.push_back({tick, T(action >> 1), bool(action & 1)});
+        }
+
+        m_mode = NONE;
+        m_seed = seed;
+        m_tick = 0;
+        m_ticks_count = ticks_count;
+        m_records = std::move(records);
+        m_play_index = 0;
+    }
+    catch (const Exception &e)
+    {
+        spdlog::warn("Can't load input replay {}: {}", file_name, e.what());
+        return false;
+    }
+
+    spdlog::info("Input replay loaded: {}, {} ticks", file_name, m_ticks_count);
+    return true;
+}
+
+template<typename T>
+void InputReplay<T>::onActionActivated(T action)
+{
+    if (m_mode == PLAYING)
+        return;
+
+    if (m_mode == RECORDING)
+        m_records.push_back({m_tick, action, true});
+
+    action_activated(action);
+}
+
+template<typename T>
+void InputReplay<T>::onActionDiactivated(T action)
+{
+    if (m_mode == PLAYING)
+        return;
+
+    if (m_mode == RECORDING)
+        m_records.push_back({m_tick, action, false});
+
+    action_diactivated(action);
+}
+
+template<typename T>
+void InputReplay<T>::writeVarint(SnapshotWriter &writer, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        writer.write(uint8_t(value | 0x80));
+        value >>= 7;
+    }
+    writer.write(uint8_t(value));
+}
+
+template<typename T>
+uint64_t InputReplay<T>::readVarint(SnapshotReader &reader)
+{
+    uint64_t value = 0;
+    for (int32_t shift = 0; shift < 64; shift += 7)
+    {
+        uint8_t byte = reader.read<uint8_t>();
+        value |= uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+
+    throw Exception{"Invalid varint in input replay"};
+}
+
+} // namespace fck
+
+#endif // INPUTREPLAY_NRKDYWQOTMZF_H
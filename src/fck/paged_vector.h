@@ -0,0 +1,84 @@
+#ifndef PAGEDVECTOR_FJWNQYBRDKZO_H
+#define PAGEDVECTOR_FJWNQYBRDKZO_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace fck
+{
+
+// Vector that stores elements in fixed size pages. Growing allocates new pages only,
+// so elements are never relocated and references to them stay valid.
+template<typename T, uint32_t PAGE_SIZE = 1024>
+class PagedVector
+{
+public:
+    PagedVector() = default;
+    explicit PagedVector(uint32_t size, const T &value = T{})
+    {
+        resize(size, value);
+    }
+    ~PagedVector() = default;
+
+    PagedVector(const PagedVector &) = delete;
+    PagedVector(PagedVector &&) = default;
+    PagedVector &operator=(const PagedVector &) = delete;
+    PagedVector &operator=(PagedVector &&) = default;
+
+    T &operator[](uint32_t index)
+    {
+        return m_pages[index / PAGE_SIZE][index % PAGE_SIZE];
+    }
+
+    const T &operator[](uint32_t index) const
+    {
+        return m_pages[index / PAGE_SIZE][index % PAGE_SIZE];
+    }
+
+    uint32_t size() const
+    {
+        return m_size;
+    }
+
+    uint32_t capacity() const
+    {
+        return m_pages.size() * PAGE_SIZE;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    void reserve(uint32_t capacity)
+    {
+        while (this->capacity() < capacity)
+            m_pages.push_back(std::make_unique<T[]>(PAGE_SIZE));
+    }
+
+    void resize(uint32_t size, const T &value = T{})
+    {
+        reserve(size);
+
+        // Elements past old size may hold values left after shrinking
+        for (uint32_t i = m_size; i < size; ++i)
+            (*this)[i] = value;
+
+        m_size = size;
+    }
+
+    void clear()
+    {
+        m_pages.clear();
+        m_size = 0;
+    }
+
+private:
+    std::vector<std::unique_ptr<T[]>> m_pages;
+    uint32_t m_size = 0;
+};
+
+} // namespace fck
+
+#endif // PAGEDVECTOR_FJWNQYBRDKZO_H
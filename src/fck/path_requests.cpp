@@ -0,0 +1,314 @@
+#include "path_requests.h"
+#include "perf_counters.h"
+#include "profiler.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <exception>
+
+namespace fck
+{
+
+PathRequests::PathRequests()
+    : m_algorithm{PathFinder::A_STAR},
+      m_incremental_replanning{false},
+      m_nodes_budget{DEFAULT_NODES_BUDGET},
+      m_nodes_limit{DEFAULT_NODES_LIMIT},
+      m_budget_carry{0},
+      m_next_request_id{0},
+      m_tick{0},
+      m_thread_pool{nullptr},
+      m_next_request{0}
+{
+    m_path_finders.resize(1);
+    m_path_finders_walls.resize(1);
+}
+
+void PathRequests::setThreadPool(ThreadPool *thread_pool)
+{
+    m_thread_pool = thread_pool;
+
+    // Calling thread takes part in work too
+    int32_t tasks_count = m_thread_pool ? m_thread_pool->getThreadsCount() + 1 : 1;
+    m_path_finders.resize(tasks_count);
+    m_path_finders_walls.resize(tasks_count);
+}
+
+void PathRequests::setWalls(const Vector2D<int32_t> &walls)
+{
+    clear();
+    m_walls = std::make_shared<const Vector2D<int32_t>>(walls);
+}
+
+void PathRequests::clear()
+{
+    m_batch.clear();
+    m_queue.clear();
+    m_owner_requests.clear();
+    m_incremental_path_finders.clear();
+    m_budget_carry = 0;
+    m_walls.reset();
+}
+
+void PathRequests::setAlgorithm(PathFinder::Algorithm algorithm)
+{
+    m_algorithm = algorithm;
+}
+
+void PathRequests::setIncrementalReplanning(bool incremental_replanning)
+{
+    m_incremental_replanning = incremental_replanning;
+    if (!m_incremental_replanning)
+        m_incremental_path_finders.clear();
+}
+
+void PathRequests::setNodesBudget(int32_t nodes_budget)
+{
+    m_nodes_budget = nodes_budget;
+}
+
+void PathRequests::setNodesLimit(int32_t nodes_limit)
+{
+    m_nodes_limit = nodes_limit;
+}
+
+void PathRequests::submit(
+    const Entity &owner, const sf::Vector2i &source, const sf::Vector2i &target, int32_t priority)
+{
+    if (!m_walls)
+        return;
+
+    uint64_t request_id = m_next_request_id++;
+
+    OwnerRequest &owner_request
+        = m_owner_requests.try_emplace(owner.getId(), OwnerRequest{0, {}, -1}).first->second;
+    owner_request.id = request_id;
+    owner_request.target = target;
+
+    if (owner_request.queue_index == -1)
+    {
+        owner_request.queue_index = int32_t(m_queue.size());
+        m_queue.push_back({});
+    }
+
+    Request &request = m_queue[owner_request.queue_index];
+    request.id = request_id;
+    request.owner = owner;
+    request.source = source;
+    request.target = target;
+    request.priority = priority;
+    request.estimated_cost = estimateCost(owner, source, target);
+    request.algorithm = m_algorithm;
+    request.nodes_limit = m_nodes_limit;
+    request.incremental_path_finder = nullptr;
+}
+
+bool PathRequests::isPending(const Entity &owner) const
+{
+    return m_owner_requests.count(owner.getId()) > 0;
+}
+
+bool PathRequests::isPending(const Entity &owner, const sf::Vector2i &target) const
+{
+    auto owner_request_found = m_owner_requests.find(owner.getId());
+    return owner_request_found != m_owner_requests.end()
+        && owner_request_found->second.target == target;
+}
+
+std::vector<PathRequests::Result> PathRequests::update()
+{
+    FCK_PROFILE_ZONE("PathRequests::update");
+
+    std::vector<Result> results;
+    results.reserve(m_batch.size());
+
+    int32_t nodes_used = 0;
+    int32_t nodes_granted = 0;
+
+    for (Request &request : m_batch)
+    {
+        nodes_used += request.expanded_count;
+        nodes_granted += request.estimated_cost;
+
+        // Owner submitted newer request
+        auto owner_request_found = m_owner_requests.find(request.owner.getId());
+        if (owner_request_found == m_owner_requests.end()
+            || owner_request_found->second.id != request.id)
+            continue;
+
+        m_owner_requests.erase(owner_request_found);
+        results.push_back({request.owner, std::move(request.path), request.complete});
+    }
+
+    m_batch.clear();
+
+    // Spent more than granted, take it from this tick
+    m_budget_carry = std::min(0, m_budget_carry + nodes_granted - nodes_used);
+
+    FCK_PERF_COUNTER_ADD("PathRequests delivered", results.size());
+
+    ++m_tick;
+    for (auto it = m_incremental_path_finders.begin(); it != m_incremental_path_finders.end();)
+    {
+        if (it->second.last_tick + INCREMENTAL_PATH_FINDER_TICKS < m_tick)
+            it = m_incremental_path_finders.erase(it);
+        else
+            ++it;
+    }
+
+    dispatch();
+
+    return results;
+}
+
+void PathRequests::dispatch()
+{
+    int32_t nodes_available = m_nodes_budget + m_budget_carry;
+    int32_t nodes_reserved = 0;
+    std::size_t requests_count = 0;
+
+    if (m_walls && nodes_available > 0)
+    {
+        // Bigger priority first, older first on same priority
+        std::sort(
+            m_queue.begin(), m_queue.end(), [](const Request &first, const Request &second) {
+                if (first.priority == second.priority)
+                    return first.id < second.id;
+                return first.priority > second.priority;
+            });
+
+        while (requests_count < m_queue.size() && nodes_reserved < nodes_available)
+            nodes_reserved += m_queue[requests_count++].estimated_cost;
+    }
+
+    // Tick is granted estimated costs, rest of debt waits for next ticks
+    m_budget_carry = std::min(0, nodes_available - nodes_reserved);
+
+    if (requests_count == 0)
+    {
+        updateQueueIndexes();
+        return;
+    }
+
+    for (std::size_t i = 0; i < requests_count; ++i)
+        m_owner_requests.find(m_queue[i].owner.getId())->second.queue_index = -1;
+
+    if (m_incremental_replanning)
+    {
+        for (std::size_t i = 0; i < requests_count; ++i)
+        {
+            Request &request = m_queue[i];
+            OwnerPathFinder &owner_path_finder
+                = m_incremental_path_finders[request.owner.getId()];
+
+            // Walls of owner search tree are same while it exists, clear drops trees
+            if (!owner_path_finder.path_finder)
+                owner_path_finder.path_finder = std::make_unique<IncrementalPathFinder>(*m_walls);
+
+            owner_path_finder.last_tick = m_tick;
+            request.incremental_path_finder = owner_path_finder.path_finder.get();
+        }
+    }
+
+    m_batch.assign(
+        std::make_move_iterator(m_queue.begin()),
+        std::make_move_iterator(m_queue.begin() + requests_count));
+
+    m_queue.erase(m_queue.begin(), m_queue.begin() + requests_count);
+    updateQueueIndexes();
+
+    FCK_PERF_COUNTER_ADD("PathRequests dispatched", requests_count);
+
+    searchBatch();
+}
+
+void PathRequests::searchBatch()
+{
+    m_next_request = 0;
+
+    int32_t tasks_count = std::min(int32_t(m_path_finders.size()), int32_t(m_batch.size()));
+    if (tasks_count <= 1)
+    {
+        searchRequests(0);
+        return;
+    }
+
+    m_tasks.clear();
+    for (int32_t i = 0; i < tasks_count; ++i)
+        m_tasks.push_back([this, i]() { searchRequests(i); });
+
+    m_thread_pool->run(m_tasks);
+}
+
+void PathRequests::updateQueueIndexes()
+{
+    for (int32_t i = 0; i < int32_t(m_queue.size()); ++i)
+        m_owner_requests.find(m_queue[i].owner.getId())->second.queue_index = i;
+}
+
+void PathRequests::searchRequests(int32_t task_index)
+{
+    // Requests are taken one by one, so long searches don't leave other tasks idle
+    for (std::size_t i = m_next_request++; i < m_batch.size(); i = m_next_request++)
+        searchRequest(task_index, m_batch[i]);
+}
+
+void PathRequests::searchRequest(int32_t task_index, Request &request)
+{
+    try
+    {
+        FCK_PROFILE_ZONE("PathRequests search");
+
+        if (request.incremental_path_finder)
+        {
+            IncrementalPathFinder &path_finder = *request.incremental_path_finder;
+            path_finder.setNodesLimit(request.nodes_limit);
+
+            request.path = path_finder.findPath(request.source, request.target);
+            request.expanded_count = path_finder.getExpandedCount();
+            request.complete = !path_finder.isNodesLimitReached();
+        }
+        else
+        {
+            PathFinder &path_finder = m_path_finders[task_index];
+            if (m_path_finders_walls[task_index] != m_walls)
+            {
+                m_path_finders_walls[task_index] = m_walls;
+                path_finder.setWalls(*m_walls);
+            }
+
+            path_finder.setAlgorithm(request.algorithm);
+            path_finder.setNodesLimit(request.nodes_limit);
+
+            request.path = path_finder.findPath(request.source, request.target);
+            request.expanded_count = path_finder.getExpandedCount();
+            request.complete = !path_finder.isNodesLimitReached();
+        }
+    }
+    catch (const std::exception &e)
+    {
+        spdlog::error("Path request failed: {}", e.what());
+        if (request.incremental_path_finder)
+            request.incremental_path_finder->reset();
+        request.path.clear();
+        request.expanded_count = 0;
+        request.complete = false;
+    }
+}
+
+int32_t PathRequests::estimateCost(
+    const Entity &owner, const sf::Vector2i &source, const sf::Vector2i &target) const
+{
+    // Searches expand about some nodes per cell of straight path
+    int32_t cells_count = std::max(std::abs(target.x - source.x), std::abs(target.y - source.y));
+    int32_t estimated_cost = std::clamp(cells_count * 4, 16, std::max(m_nodes_limit, 16));
+
+    // Replanning repairs only part of previous tree
+    if (m_incremental_replanning && m_incremental_path_finders.count(owner.getId()) > 0)
+        estimated_cost = std::min(estimated_cost, INCREMENTAL_ESTIMATED_COST);
+
+    return estimated_cost;
+}
+
+} // namespace fck
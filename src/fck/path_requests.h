@@ -0,0 +1,158 @@
+#ifndef PATHREQUESTS_RKWPFNDLUQXE_H
+#define PATHREQUESTS_RKWPFNDLUQXE_H
+
+#include "a_star.h"
+#include "entity.h"
+#include "incremental_path_finder.h"
+#include "thread_pool.h"
+#include "vector_2d.h"
+
+#include <SFML/System/Vector2.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace fck
+{
+
+// Path searches of owners in batches. Requests of tick are searched on shared thread pool on
+// snapshot of walls, results are delivered by update at start of next tick. Every tick takes
+// requests by priority while their estimated cost fits nodes budget, overspending of tick is
+// taken from budget of next tick. Delivered results don't depend on threads timing. With
+// incremental replanning every owner keeps its own search tree, so repeated requests of moving
+// owner to moving target reuse previous search.
+class PathRequests
+{
+public:
+    struct Result
+    {
+        Entity owner;
+        // Same format as PathFinder::findPath
+        std::vector<sf::Vector2i> path;
+        // False if search reached nodes limit
+        bool complete;
+    };
+
+    static constexpr int32_t DEFAULT_NODES_BUDGET = 8192;
+    static constexpr int32_t DEFAULT_NODES_LIMIT = 4096;
+    // Search tree of owner without requests for this count of ticks is dropped
+    static constexpr uint64_t INCREMENTAL_PATH_FINDER_TICKS = 600;
+
+    PathRequests();
+    ~PathRequests() = default;
+
+    PathRequests(const PathRequests &) = delete;
+    PathRequests(PathRequests &&) = delete;
+    PathRequests &operator=(const PathRequests &) = delete;
+    PathRequests &operator=(PathRequests &&) = delete;
+
+    // Batches are searched by calling thread without pool
+    void setThreadPool(ThreadPool *thread_pool);
+
+    // Copies walls, requests of previous walls are dropped
+    void setWalls(const Vector2D<int32_t> &walls);
+    void clear();
+
+    void setAlgorithm(PathFinder::Algorithm algorithm);
+    // Searches by IncrementalPathFinder of owner instead of algorithm
+    void setIncrementalReplanning(bool incremental_replanning);
+    // Nodes expanded by all searches of one tick
+    void setNodesBudget(int32_t nodes_budget);
+    // Nodes expanded by one search
+    void setNodesLimit(int32_t nodes_limit);
+
+    // Replaces not started request of same owner, bigger priority is searched first
+    void submit(
+        const Entity &owner,
+        const sf::Vector2i &source,
+        const sf::Vector2i &target,
+        int32_t priority = 0);
+    bool isPending(const Entity &owner) const;
+    bool isPending(const Entity &owner, const sf::Vector2i &target) const;
+
+    // Called at start of tick. Returns results of previous tick and searches batch of this
+    // tick, its results are returned by next update.
+    std::vector<Result> update();
+
+private:
+    struct Request
+    {
+        uint64_t id;
+        Entity owner;
+        sf::Vector2i source;
+        sf::Vector2i target;
+        int32_t priority;
+        int32_t estimated_cost;
+        PathFinder::Algorithm algorithm;
+        int32_t nodes_limit;
+        // Owned by m_incremental_path_finders, only request of its owner uses it in batch
+        IncrementalPathFinder *incremental_path_finder;
+
+        std::vector<sf::Vector2i> path;
+        int32_t expanded_count;
+        bool complete;
+    };
+
+    void dispatch();
+    void searchBatch();
+    // Queue is reordered by dispatch
+    void updateQueueIndexes();
+
+    // Takes requests of batch until all of them are taken
+    void searchRequests(int32_t task_index);
+    void searchRequest(int32_t task_index, Request &request);
+
+    int32_t estimateCost(
+        const Entity &owner, const sf::Vector2i &source, const sf::Vector2i &target) const;
+
+private:
+    static constexpr int32_t INCREMENTAL_ESTIMATED_COST = 64;
+
+    std::shared_ptr<const Vector2D<int32_t>> m_walls;
+    PathFinder::Algorithm m_algorithm;
+    bool m_incremental_replanning;
+    int32_t m_nodes_budget;
+    int32_t m_nodes_limit;
+    // Negative if previous ticks spent more than budget
+    int32_t m_budget_carry;
+
+    uint64_t m_next_request_id;
+    std::vector<Request> m_queue;
+    struct OwnerRequest
+    {
+        uint64_t id;
+        sf::Vector2i target;
+        // Index of not started request in queue, -1 if request is dispatched
+        int32_t queue_index;
+    };
+
+    // Last request of every owner while it isn't delivered
+    std::unordered_map<Id, OwnerRequest> m_owner_requests;
+
+    struct OwnerPathFinder
+    {
+        std::unique_ptr<IncrementalPathFinder> path_finder;
+        uint64_t last_tick;
+    };
+
+    std::unordered_map<Id, OwnerPathFinder> m_incremental_path_finders;
+    uint64_t m_tick;
+
+    ThreadPool *m_thread_pool;
+    std::vector<std::function<void()>> m_tasks;
+
+    // Path finder of every task. Walls of path finder are kept alive, so their address isn't
+    // reused by new snapshot
+    std::vector<PathFinder> m_path_finders;
+    std::vector<std::shared_ptr<const Vector2D<int32_t>>> m_path_finders_walls;
+
+    std::vector<Request> m_batch;
+    std::atomic<std::size_t> m_next_request;
+};
+
+} // namespace fck
+
+#endif // PATHREQUESTS_RKWPFNDLUQXE_H
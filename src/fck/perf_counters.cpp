@@ -0,0 +1,242 @@
+#include "perf_counters.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+
+namespace fck
+{
+
+// Outside of PerfCounters instance, allocations happen before and while it is created
+static std::atomic<int64_t> allocations_count{0};
+
+int32_t PerfCounters::registerCounter(const std::string &name, Type type)
+{
+    PerfCounters &perf_counters = instance();
+    std::lock_guard<std::mutex> lock{perf_counters.m_counters_mutex};
+
+    for (int32_t i = 0; i < int32_t(perf_counters.m_counters.size()); ++i)
+    {
+        if (perf_counters.m_counters[i].name == name)
+            return i;
+    }
+
+    if (perf_counters.m_counters.size() == MAX_COUNTERS)
+    {
+        spdlog::warn("Maximum amount of performance counters exceeded: {}", name);
+        return -1;
+    }
+
+    perf_counters.m_counters.push_back({name, type});
+    return perf_counters.m_counters.size() - 1;
+}
+
+void PerfCounters::add(int32_t id, int64_t value)
+{
+    if (id < 0)
+        return;
+
+    instance().m_values[id].fetch_add(value, std::memory_order_relaxed);
+}
+
+void PerfCounters::set(int32_t id, int64_t value)
+{
+    if (id < 0)
+        return;
+
+    instance().m_values[id].store(value, std::memory_order_relaxed);
+}
+
+void PerfCounters::nextFrame()
+{
+    PerfCounters &perf_counters = instance();
+
+    set(perf_counters.m_allocations_id, allocations_count.exchange(0, std::memory_order_relaxed));
+
+    std::lock_guard<std::mutex> lock{perf_counters.m_counters_mutex};
+
+    int32_t count = perf_counters.m_counters.size();
+    perf_counters.m_frame_values.resize(count);
+
+    int64_t *history_values
+        = &perf_counters.m_history[(perf_counters.m_history_count % HISTORY_SIZE) * MAX_COUNTERS];
+
+    for (int32_t i = 0; i < count; ++i)
+    {
+        int64_t value = perf_counters.m_counters[i].type == Type::COUNTER
+                            ? perf_counters.m_values[i].exchange(0, std::memory_order_relaxed)
+                            : perf_counters.m_values[i].load(std::memory_order_relaxed);
+
+        perf_counters.m_frame_values[i] = value;
+        history_values[i] = value;
+    }
+
+    ++perf_counters.m_history_count;
+}
+
+int32_t PerfCounters::getCount()
+{
+    PerfCounters &perf_counters = instance();
+    std::lock_guard<std::mutex> lock{perf_counters.m_counters_mutex};
+    return perf_counters.m_counters.size();
+}
+
+const std::string &PerfCounters::getName(int32_t id)
+{
+    PerfCounters &perf_counters = instance();
+    std::lock_guard<std::mutex> lock{perf_counters.m_counters_mutex};
+    return perf_counters.m_counters[id].name;
+}
+
+const std::vector<int64_t> &PerfCounters::getFrameValues()
+{
+    return instance().m_frame_values;
+}
+
+bool PerfCounters::dumpCsv(const std::string &file_name)
+{
+    std::ofstream file{file_name};
+    if (!file.is_open())
+    {
+        spdlog::warn("Can't open file to dump performance counters: {}", file_name);
+        return false;
+    }
+
+    PerfCounters &perf_counters = instance();
+    std::lock_guard<std::mutex> lock{perf_counters.m_counters_mutex};
+
+    // Counters registered after frame was taken have zero values in it
+    file << "frame";
+    for (const Counter &counter : perf_counters.m_counters)
+        file << "," << counter.name;
+    file << "\n";
+
+    uint64_t first
+        = perf_counters.m_history_count > HISTORY_SIZE ? perf_counters.m_history_count - HISTORY_SIZE
+                                                       : 0;
+
+    for (uint64_t frame = first; frame < perf_counters.m_history_count; ++frame)
+    {
+        const int64_t *history_values
+            = &perf_counters.m_history[(frame % HISTORY_SIZE) * MAX_COUNTERS];
+
+        file << frame;
+        for (std::size_t i = 0; i < perf_counters.m_counters.size(); ++i)
+            file << "," << history_values[i];
+        file << "\n";
+    }
+
+    spdlog::info("Performance counters dumped: {}", file_name);
+    return true;
+}
+
+void PerfCounters::countAllocation()
+{
+    allocations_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+PerfCounters::PerfCounters() : m_allocations_id{-1}, m_history_count{0}
+{
+    // Names are returned by reference, so counters are never relocated
+    m_counters.reserve(MAX_COUNTERS);
+
+    for (std::atomic<int64_t> &value : m_values)
+        value.store(0, std::memory_order_relaxed);
+
+    m_history.resize(HISTORY_SIZE * MAX_COUNTERS, 0);
+
+    m_counters.push_back({"allocations", Type::GAUGE});
+    m_allocations_id = 0;
+}
+
+PerfCounters &PerfCounters::instance()
+{
+    static PerfCounters perf_counters;
+    return perf_counters;
+}
+
+} // namespace fck
+
+#ifdef FCK_COUNT_ALLOCATIONS
+
+void *operator new(std::size_t size)
+{
+    fck::PerfCounters::countAllocation();
+
+    if (size == 0)
+        size = 1;
+
+    void *pointer = std::malloc(size);
+    if (!pointer)
+        throw std::bad_alloc{};
+    return pointer;
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    fck::PerfCounters::countAllocation();
+
+    // Size of aligned_alloc is multiple of alignment
+    std::size_t align = std::size_t(alignment);
+    size = (std::max(size, std::size_t(1)) + align - 1) / align * align;
+
+    void *pointer = std::aligned_alloc(align, size);
+    if (!pointer)
+        throw std::bad_alloc{};
+    return pointer;
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef PERFCOUNTERS_WJXKQPLZMDNB_H
+#define PERFCOUNTERS_WJXKQPLZMDNB_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace fck
+{
+
+// Adds value to counter registered once per call site
+#define FCK_PERF_COUNTER_ADD(_name_, _value_) \
+    { \
+        static const int32_t perf_counter_id = ::fck::PerfCounters::registerCounter(_name_); \
+        ::fck::PerfCounters::add(perf_counter_id, _value_); \
+    }
+
+// Named workload counters. Counters are reset every frame, gauges keep last set value.
+// Values are atomic, so they are updated from any thread without lock. nextFrame takes
+// snapshot of all values to rolling history, which is written to CSV by dumpCsv.
+class PerfCounters
+{
+public:
+    enum class Type
+    {
+        COUNTER,
+        GAUGE
+    };
+
+    static constexpr int32_t MAX_COUNTERS = 128;
+    static constexpr int32_t HISTORY_SIZE = 3600;
+
+    // Same name gives same id
+    static int32_t registerCounter(const std::string &name, Type type = Type::COUNTER);
+
+    static void add(int32_t id, int64_t value = 1);
+    static void set(int32_t id, int64_t value);
+
+    static void nextFrame();
+
+    static int32_t getCount();
+    static const std::string &getName(int32_t id);
+    // Values of last finished frame
+    static const std::vector<int64_t> &getFrameValues();
+
+    // History of frames, one line per frame, one column per counter
+    static bool dumpCsv(const std::string &file_name);
+
+    // Called by global allocation functions when FCK_COUNT_ALLOCATIONS is defined
+    static void countAllocation();
+
+private:
+    struct Counter
+    {
+        std::string name;
+        Type type;
+    };
+
+    PerfCounters();
+    ~PerfCounters() = default;
+
+    static PerfCounters &instance();
+
+private:
+    std::mutex m_counters_mutex;
+    std::vector<Counter> m_counters;
+    std::array<std::atomic<int64_t>, MAX_COUNTERS> m_values;
+    int32_t m_allocations_id;
+
+    std::vector<int64_t> m_frame_values;
+    // Ring buffer of frames, each frame takes MAX_COUNTERS values
+    std::vector<int64_t> m_history;
+    uint64_t m_history_count;
+};
+
+} // namespace fck
+
+#endif // PERFCOUNTERS_WJXKQPLZMDNB_H
@@ -0,0 +1,225 @@
+#include "profiler.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <string_view>
+#include <unordered_map>
+
+namespace fck
+{
+
+void Profiler::setEnabled(bool enabled)
+{
+    instance().m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Profiler::isEnabled()
+{
+    return instance().m_enabled.load(std::memory_order_relaxed);
+}
+
+int64_t Profiler::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void Profiler::nextFrame()
+{
+    Profiler &profiler = instance();
+
+    int64_t frame_end = now();
+    int64_t frame_begin = profiler.m_frame_begin;
+
+    profiler.m_frame_begin = frame_end;
+    profiler.m_frame_time = double(frame_end - frame_begin) / 1000000;
+    profiler.m_frame_stats.clear();
+    profiler.m_frame_stats_complete = true;
+
+    if (!isEnabled())
+        return;
+
+    std::unordered_map<std::string_view, std::size_t> stats_indexes;
+
+    std::lock_guard<std::mutex> lock{profiler.m_threads_mutex};
+    for (const std::unique_ptr<ThreadZones> &thread_zones : profiler.m_threads)
+    {
+        uint64_t count = thread_zones->count.load(std::memory_order_acquire);
+        uint64_t first = count > ZONES_CAPACITY ? count - ZONES_CAPACITY : 0;
+
+        // Zones are written when they end, go back until zones of previous frames
+        bool previous_frame_reached = false;
+        for (uint64_t i = count; i > first; --i)
+        {
+            const Zone &zone = thread_zones->zones[(i - 1) % ZONES_CAPACITY];
+            if (zone.end < frame_begin)
+            {
+                previous_frame_reached = true;
+                break;
+            }
+
+            if (zone.begin >= frame_end)
+                continue;
+
+            auto stats_found = stats_indexes.find(zone.name);
+            if (stats_found == stats_indexes.end())
+            {
+                stats_found
+                    = stats_indexes.emplace(zone.name, profiler.m_frame_stats.size()).first;
+                profiler.m_frame_stats.push_back({zone.name, zone.depth, 0, 0, 0});
+            }
+
+            ZoneStats &stats = profiler.m_frame_stats[stats_found->second];
+            double time = double(zone.end - zone.begin) / 1000000;
+
+            stats.depth = std::min(stats.depth, zone.depth);
+            ++stats.calls;
+            stats.total_time += time;
+            stats.max_time = std::max(stats.max_time, time);
+        }
+
+        if (!previous_frame_reached && first > 0)
+            profiler.m_frame_stats_complete = false;
+    }
+
+    std::sort(
+        profiler.m_frame_stats.begin(),
+        profiler.m_frame_stats.end(),
+        [](const ZoneStats &first, const ZoneStats &second) {
+            return first.total_time > second.total_time;
+        });
+}
+
+const std::vector<Profiler::ZoneStats> &Profiler::getFrameStats()
+{
+    return instance().m_frame_stats;
+}
+
+bool Profiler::isFrameStatsComplete()
+{
+    return instance().m_frame_stats_complete;
+}
+
+double Profiler::getFrameTime()
+{
+    return instance().m_frame_time;
+}
+
+bool Profiler::exportChromeTrace(const std::string &file_name)
+{
+    std::ofstream file{file_name};
+    if (!file.is_open())
+    {
+        spdlog::warn("Can't open file to export profiler trace: {}", file_name);
+        return false;
+    }
+
+    Profiler &profiler = instance();
+
+    file << std::fixed << std::setprecision(3);
+    file << "{\"traceEvents\":[";
+
+    bool first_event = true;
+
+    std::lock_guard<std::mutex> lock{profiler.m_threads_mutex};
+    for (const std::unique_ptr<ThreadZones> &thread_zones : profiler.m_threads)
+    {
+        uint64_t count = thread_zones->count.load(std::memory_order_acquire);
+        uint64_t first = count > ZONES_CAPACITY ? count - ZONES_CAPACITY : 0;
+
+        for (uint64_t i = first; i < count; ++i)
+        {
+            const Zone &zone = thread_zones->zones[i % ZONES_CAPACITY];
+
+            if (!first_event)
+                file << ",";
+            first_event = false;
+
+            file << "{\"name\":\"";
+            for (const char *c = zone.name; *c; ++c)
+            {
+                if (*c == '"' || *c == '\\')
+                    file << '\\';
+                file << *c;
+            }
+
+            // Trace times are microseconds
+            file << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << thread_zones->thread_index
+                 << ",\"ts\":" << double(zone.begin) / 1000
+                 << ",\"dur\":" << double(zone.end - zone.begin) / 1000 << "}";
+        }
+    }
+
+    file << "]}";
+
+    spdlog::info("Profiler trace exported: {}", file_name);
+    return true;
+}
+
+Profiler::Profiler()
+    : m_enabled{false}, m_frame_begin{now()}, m_frame_time{0}, m_frame_stats_complete{true}
+{
+}
+
+Profiler &Profiler::instance()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::ThreadZones &Profiler::threadZones()
+{
+    thread_local ThreadZones *thread_zones = nullptr;
+
+    if (!thread_zones)
+    {
+        Profiler &profiler = instance();
+        std::lock_guard<std::mutex> lock{profiler.m_threads_mutex};
+
+        auto new_thread_zones = std::make_unique<ThreadZones>();
+        new_thread_zones->zones.resize(ZONES_CAPACITY);
+        new_thread_zones->count.store(0, std::memory_order_relaxed);
+        new_thread_zones->thread_index = profiler.m_threads.size();
+        new_thread_zones->depth = 0;
+
+        thread_zones = new_thread_zones.get();
+        profiler.m_threads.push_back(std::move(new_thread_zones));
+    }
+
+    return *thread_zones;
+}
+
+void Profiler::addZone(ThreadZones &thread_zones, const Zone &zone)
+{
+    uint64_t count = thread_zones.count.load(std::memory_order_relaxed);
+    thread_zones.zones[count % ZONES_CAPACITY] = zone;
+    thread_zones.count.store(count + 1, std::memory_order_release);
+}
+
+ProfileZone::ProfileZone(const char *name)
+    : m_name{name}, m_begin{0}, m_thread_zones{nullptr}
+{
+    if (!Profiler::isEnabled())
+        return;
+
+    m_thread_zones = &Profiler::threadZones();
+    ++m_thread_zones->depth;
+    m_begin = Profiler::now();
+}
+
+ProfileZone::~ProfileZone()
+{
+    if (!m_thread_zones)
+        return;
+
+    --m_thread_zones->depth;
+    Profiler::addZone(
+        *m_thread_zones, {m_name, m_begin, Profiler::now(), m_thread_zones->depth});
+}
+
+} // namespace fck
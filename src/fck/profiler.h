@@ -0,0 +1,113 @@
+#ifndef PROFILER_TBNQXWOAZKJM_H
+#define PROFILER_TBNQXWOAZKJM_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace fck
+{
+
+#define FCK_PROFILE_CONCAT_IMPL(_a_, _b_) _a_##_b_
+#define FCK_PROFILE_CONCAT(_a_, _b_) FCK_PROFILE_CONCAT_IMPL(_a_, _b_)
+
+// Name must outlive profiler, string literals are fine
+#define FCK_PROFILE_ZONE(_name_) \
+    ::fck::ProfileZone FCK_PROFILE_CONCAT(profile_zone_, __LINE__) \
+    { \
+        _name_ \
+    }
+
+// Timings of named zones. Every thread writes finished zones to its own ring buffer,
+// so recording takes no lock. Stats of frame and trace export read buffers of all threads
+// and should be called when other threads have no zones open.
+class Profiler
+{
+public:
+    struct Zone
+    {
+        const char *name;
+        int64_t begin; // ns
+        int64_t end; // ns
+        int32_t depth;
+    };
+
+    struct ZoneStats
+    {
+        std::string name;
+        int32_t depth;
+        int32_t calls;
+        double total_time; // ms
+        double max_time; // ms
+    };
+
+    static constexpr uint32_t ZONES_CAPACITY = 1 << 15;
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    // Nanoseconds of steady clock
+    static int64_t now();
+
+    // Ends frame and collects stats of its zones, they are kept until next call
+    static void nextFrame();
+    static const std::vector<ZoneStats> &getFrameStats();
+    // False if ring buffer of some thread wrapped within frame and its first zones are lost
+    static bool isFrameStatsComplete();
+    static double getFrameTime();
+
+    // Zones still kept in buffers, in Chrome trace event format
+    static bool exportChromeTrace(const std::string &file_name);
+
+private:
+    friend class ProfileZone;
+
+    struct ThreadZones
+    {
+        std::vector<Zone> zones;
+        std::atomic<uint64_t> count;
+        int32_t thread_index;
+        int32_t depth;
+    };
+
+    Profiler();
+    ~Profiler() = default;
+
+    static Profiler &instance();
+    static ThreadZones &threadZones();
+
+    static void addZone(ThreadZones &thread_zones, const Zone &zone);
+
+private:
+    std::atomic<bool> m_enabled;
+
+    std::mutex m_threads_mutex;
+    std::vector<std::unique_ptr<ThreadZones>> m_threads;
+
+    int64_t m_frame_begin;
+    double m_frame_time;
+    std::vector<ZoneStats> m_frame_stats;
+    bool m_frame_stats_complete;
+};
+
+class ProfileZone
+{
+public:
+    explicit ProfileZone(const char *name);
+    ~ProfileZone();
+
+    ProfileZone(const ProfileZone &) = delete;
+    ProfileZone &operator=(const ProfileZone &) = delete;
+
+private:
+    const char *m_name;
+    int64_t m_begin;
+    Profiler::ThreadZones *m_thread_zones;
+};
+
+} // namespace fck
+
+#endif // PROFILER_TBNQXWOAZKJM_H
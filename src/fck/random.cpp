@@ -0,0 +1,54 @@
+#include "random.h"
+
+#include <spdlog/spdlog.h>
+
+namespace fck
+{
+
+void Random::setSeed(uint32_t seed)
+{
+    Random &random = instance();
+    std::lock_guard<std::mutex> lock{random.m_mutex};
+
+    spdlog::info("Random seed: {}", seed);
+
+    random.m_seed = seed;
+    random.m_engine.seed(seed);
+}
+
+uint32_t Random::getSeed()
+{
+    Random &random = instance();
+    std::lock_guard<std::mutex> lock{random.m_mutex};
+    return random.m_seed;
+}
+
+int32_t Random::uniformInt(int32_t min, int32_t max)
+{
+    Random &random = instance();
+    std::lock_guard<std::mutex> lock{random.m_mutex};
+
+    std::uniform_int_distribution<int32_t> dist{min, max};
+    return dist(random.m_engine);
+}
+
+float Random::uniformReal(float min, float max)
+{
+    Random &random = instance();
+    std::lock_guard<std::mutex> lock{random.m_mutex};
+
+    std::uniform_real_distribution<float> dist{min, max};
+    return dist(random.m_engine);
+}
+
+Random::Random() : m_seed{std::random_device{}()}, m_engine{m_seed}
+{
+}
+
+Random &Random::instance()
+{
+    static Random random;
+    return random;
+}
+
+} // namespace fck
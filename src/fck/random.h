@@ -0,0 +1,37 @@
+#ifndef RANDOM_HVQZLTNWXCPE_H
+#define RANDOM_HVQZLTNWXCPE_H
+
+#include <cstdint>
+#include <mutex>
+#include <random>
+
+namespace fck
+{
+
+// Single random engine of game. Same seed gives same sequence, so generated maps and
+// skills with same inputs repeat exactly. Seed of random device is used until setSeed.
+class Random
+{
+public:
+    static void setSeed(uint32_t seed);
+    static uint32_t getSeed();
+
+    // Values in [min, max]
+    static int32_t uniformInt(int32_t min, int32_t max);
+    static float uniformReal(float min, float max);
+
+private:
+    Random();
+    ~Random() = default;
+
+    static Random &instance();
+
+private:
+    std::mutex m_mutex;
+    uint32_t m_seed;
+    std::mt19937 m_engine;
+};
+
+} // namespace fck
+
+#endif // RANDOM_HVQZLTNWXCPE_H
@@ -0,0 +1,105 @@
+#include "snapshot.h"
+#include "world.h"
+
+namespace fck
+{
+
+SnapshotWriter::SnapshotWriter(std::vector<char> &data) : m_data{&data}
+{
+}
+
+void SnapshotWriter::writeString(const std::string &string)
+{
+    write(uint32_t(string.size()));
+
+    std::size_t position = m_data->size();
+    m_data->resize(position + string.size());
+    std::memcpy(m_data->data() + position, string.data(), string.size());
+}
+
+void SnapshotWriter::writeEntity(const Entity &entity)
+{
+    write(entity.getId().getId());
+}
+
+std::size_t SnapshotWriter::getPosition() const
+{
+    return m_data->size();
+}
+
+SnapshotReader::SnapshotReader(const std::vector<char> &data, World *world)
+    : m_data{&data}, m_position{0}, m_world{world}, m_entity_index{0}
+{
+}
+
+std::string SnapshotReader::readString()
+{
+    uint32_t size = read<uint32_t>();
+    fck_assert(m_position + size <= m_data->size(), "Unexpected end of snapshot data");
+
+    std::string string(m_data->data() + m_position, size);
+    m_position += size;
+    return string;
+}
+
+Entity SnapshotReader::readEntity()
+{
+    Id id{read<uint64_t>()};
+    return id == Id::invalid ? Entity{} : Entity{id, m_world};
+}
+
+void SnapshotReader::setEntityIndex(uint32_t entity_index)
+{
+    m_entity_index = entity_index;
+}
+
+Entity SnapshotReader::getEntity() const
+{
+    return m_world ? m_world->getEntity(m_entity_index) : Entity{};
+}
+
+void SnapshotReader::skip(std::size_t size)
+{
+    fck_assert(m_position + size <= m_data->size(), "Unexpected end of snapshot data");
+    m_position += size;
+}
+
+std::size_t SnapshotReader::getPosition() const
+{
+    return m_position;
+}
+
+void SnapshotReader::readBytes(void *value, std::size_t size)
+{
+    fck_assert(m_position + size <= m_data->size(), "Unexpected end of snapshot data");
+
+    std::memcpy(value, m_data->data() + m_position, size);
+    m_position += size;
+}
+
+const std::vector<ComponentSerializer::Serializer> &ComponentSerializer::getSerializers()
+{
+    return instance().m_serializers;
+}
+
+const ComponentSerializer::Serializer *ComponentSerializer::findSerializer(const std::string &name)
+{
+    auto serializer_found = instance().m_serializer_indexes.find(name);
+    if (serializer_found == instance().m_serializer_indexes.end())
+        return nullptr;
+    return &instance().m_serializers[serializer_found->second];
+}
+
+void ComponentSerializer::addSerializer(Serializer &&serializer)
+{
+    instance().m_serializer_indexes[serializer.name] = instance().m_serializers.size();
+    instance().m_serializers.push_back(std::move(serializer));
+}
+
+ComponentSerializer &ComponentSerializer::instance()
+{
+    static ComponentSerializer component_serializer;
+    return component_serializer;
+}
+
+} // namespace fck
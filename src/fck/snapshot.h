@@ -0,0 +1,248 @@
+#ifndef SNAPSHOT_WQLZNEHCKTRB_H
+#define SNAPSHOT_WQLZNEHCKTRB_H
+
+#include "component_storage.h"
+#include "entity.h"
+#include "utilities.h"
+
+#include <spdlog/spdlog.h>
+
+#include <cstring>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace fck
+{
+
+class World;
+
+// Appends values to binary snapshot data
+class SnapshotWriter
+{
+public:
+    SnapshotWriter(std::vector<char> &data);
+    ~SnapshotWriter() = default;
+
+    template<typename T>
+    void write(const T &value);
+
+    template<typename T>
+    void writeAt(std::size_t position, const T &value);
+
+    template<typename T>
+    void writeVector(const std::vector<T> &values);
+
+    void writeString(const std::string &string);
+    void writeEntity(const Entity &entity);
+
+    std::size_t getPosition() const;
+
+private:
+    std::vector<char> *m_data;
+};
+
+// Reads values of binary snapshot data, throws Exception when data ends too early
+class SnapshotReader
+{
+public:
+    SnapshotReader(const std::vector<char> &data, World *world);
+    ~SnapshotReader() = default;
+
+    template<typename T>
+    T read();
+
+    template<typename T>
+    std::vector<T> readVector();
+
+    std::string readString();
+    Entity readEntity();
+
+    // Entity of component being restored
+    void setEntityIndex(uint32_t entity_index);
+    Entity getEntity() const;
+
+    void skip(std::size_t size);
+
+    std::size_t getPosition() const;
+
+private:
+    void readBytes(void *value, std::size_t size);
+
+private:
+    const std::vector<char> *m_data;
+    std::size_t m_position;
+    World *m_world;
+    uint32_t m_entity_index;
+};
+
+#define REGISTER_COMPONENT_SERIALIZER(_name_, _class_) \
+    inline const bool component_serializer_##_class_ \
+        = ::fck::ComponentSerializer::registerComponentSerializer<_class_>(_name_)
+
+// Components which can't be rebuilt from snapshot data (resources, lua state), only their count
+// is written and restore warns that they are lost
+#define REGISTER_COMPONENT_NOT_SERIALIZED(_name_, _class_) \
+    inline const bool component_not_serialized_##_class_ \
+        = ::fck::ComponentSerializer::registerNotSerializedComponent<_class_>(_name_)
+
+// Components of type T are written to world snapshot by free functions
+// serialize(SnapshotWriter &, const T &) and deserialize(SnapshotReader &, T &),
+// found by argument dependent lookup. Name identifies type in snapshot data.
+class ComponentSerializer
+{
+public:
+    struct Serializer
+    {
+        std::string name;
+        std::function<uint32_t(SnapshotWriter &, ComponentStorage &)> save;
+        std::function<void(SnapshotReader &, ComponentStorage &, uint32_t)> restore;
+    };
+
+    template<typename T>
+    static bool registerComponentSerializer(const std::string &name);
+    template<typename T>
+    static bool registerNotSerializedComponent(const std::string &name);
+
+    static const std::vector<Serializer> &getSerializers();
+    static const Serializer *findSerializer(const std::string &name);
+
+private:
+    static ComponentSerializer &instance();
+    static void addSerializer(Serializer &&serializer);
+
+    ComponentSerializer() = default;
+    ~ComponentSerializer() = default;
+
+private:
+    std::vector<Serializer> m_serializers;
+    std::unordered_map<std::string, std::size_t> m_serializer_indexes;
+};
+
+template<typename T>
+void SnapshotWriter::write(const T &value)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Type is not trivially copyable");
+
+    std::size_t position = m_data->size();
+    m_data->resize(position + sizeof(T));
+    std::memcpy(m_data->data() + position, &value, sizeof(T));
+}
+
+template<typename T>
+void SnapshotWriter::writeAt(std::size_t position, const T &value)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Type is not trivially copyable");
+    fck_assert(position + sizeof(T) <= m_data->size(), "Write out of snapshot data");
+
+    std::memcpy(m_data->data() + position, &value, sizeof(T));
+}
+
+template<typename T>
+void SnapshotWriter::writeVector(const std::vector<T> &values)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Type is not trivially copyable");
+
+    write(uint32_t(values.size()));
+
+    std::size_t position = m_data->size();
+    m_data->resize(position + values.size() * sizeof(T));
+    if (!values.empty())
+        std::memcpy(m_data->data() + position, values.data(), values.size() * sizeof(T));
+}
+
+template<typename T>
+T SnapshotReader::read()
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Type is not trivially copyable");
+
+    T value;
+    readBytes(&value, sizeof(T));
+    return value;
+}
+
+template<typename T>
+std::vector<T> SnapshotReader::readVector()
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Type is not trivially copyable");
+
+    uint32_t size = read<uint32_t>();
+    fck_assert(
+        m_position + size * sizeof(T) <= m_data->size(), "Unexpected end of snapshot data");
+
+    std::vector<T> values(size);
+    if (size > 0)
+        readBytes(values.data(), size * sizeof(T));
+    return values;
+}
+
+template<typename T>
+bool ComponentSerializer::registerComponentSerializer(const std::string &name)
+{
+    spdlog::info("Register component serializer: {}", name);
+
+    Serializer serializer;
+    serializer.name = name;
+
+    serializer.save = [](SnapshotWriter &writer, ComponentStorage &component_storage) {
+        ComponentPool<T> *pool = component_storage.findPool<T>();
+        if (!pool)
+            return uint32_t(0);
+
+        for (uint32_t index : pool->getEntityIndexes())
+        {
+            writer.write(index);
+            serialize(writer, pool->get(index));
+        }
+
+        return uint32_t(pool->size());
+    };
+
+    serializer.restore =
+        [](SnapshotReader &reader, ComponentStorage &component_storage, uint32_t count) {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                uint32_t index = reader.read<uint32_t>();
+                fck_assert(
+                    index < uint32_t(component_storage.size()), "Invalid component in snapshot");
+
+                reader.setEntityIndex(index);
+                deserialize(reader, component_storage.add<T>(index));
+            }
+        };
+
+    addSerializer(std::move(serializer));
+    return true;
+}
+
+template<typename T>
+bool ComponentSerializer::registerNotSerializedComponent(const std::string &name)
+{
+    spdlog::info("Register not serialized component: {}", name);
+
+    Serializer serializer;
+    serializer.name = name;
+
+    serializer.save = []([[maybe_unused]] SnapshotWriter &writer,
+                         ComponentStorage &component_storage) {
+        ComponentPool<T> *pool = component_storage.findPool<T>();
+        return pool ? uint32_t(pool->size()) : uint32_t(0);
+    };
+
+    serializer.restore = [name](
+                             [[maybe_unused]] SnapshotReader &reader,
+                             [[maybe_unused]] ComponentStorage &component_storage,
+                             uint32_t count) {
+        if (count > 0)
+            spdlog::warn("Snapshot doesn't keep components {}, {} of them are lost", name, count);
+    };
+
+    addSerializer(std::move(serializer));
+    return true;
+}
+
+} // namespace fck
+
+#endif // SNAPSHOT_WQLZNEHCKTRB_H
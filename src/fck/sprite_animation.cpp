@@ -1,4 +1,5 @@
 #include "sprite_animation.h"
+#include "drawable_proxy.h"
 
 namespace fck
 {
@@ -13,6 +14,25 @@ SpriteAnimation::SpriteAnimation(sf::Sprite &sprite)
 {
 }
 
+DrawableAnimation *SpriteAnimation::copy(DrawableProxyBase *proxy) const
+{
+    SpriteAnimation *sprite_animation = new SpriteAnimation{*this};
+    sprite_animation->m_sprite = static_cast<sf::Sprite *>(proxy->data());
+
+    // Current state points into states of this animation
+    sprite_animation->m_current_state = nullptr;
+    for (const auto &it : m_states)
+    {
+        if (&it.second == m_current_state)
+        {
+            sprite_animation->m_current_state = &sprite_animation->m_states.find(it.first)->second;
+            break;
+        }
+    }
+
+    return sprite_animation;
+}
+
 sf::Sprite *SpriteAnimation::getSprite() const
 {
     return m_sprite;
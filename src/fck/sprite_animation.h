@@ -26,6 +26,8 @@ public:
     SpriteAnimation(sf::Sprite &sprite);
     ~SpriteAnimation() = default;
 
+    DrawableAnimation *copy(DrawableProxyBase *proxy) const;
+
     sf::Sprite *getSprite() const;
     void setSprite(sf::Sprite &sprite);
 
@@ -1,4 +1,5 @@
 #include "sprite_state.h"
+#include "drawable_proxy.h"
 
 namespace fck
 {
@@ -11,6 +12,13 @@ SpriteState::SpriteState(sf::Sprite &sprite) : m_sprite{&sprite}
 {
 }
 
+DrawableState *SpriteState::copy(DrawableProxyBase *proxy) const
+{
+    SpriteState *sprite_state = new SpriteState{*this};
+    sprite_state->m_sprite = static_cast<sf::Sprite *>(proxy->data());
+    return sprite_state;
+}
+
 sf::Sprite *SpriteState::getSprite() const
 {
     return m_sprite;
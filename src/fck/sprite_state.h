@@ -17,6 +17,8 @@ public:
     SpriteState(sf::Sprite &sprite);
     ~SpriteState() = default;
 
+    DrawableState *copy(DrawableProxyBase *proxy) const;
+
     sf::Sprite *getSprite() const;
     void setSprite(sf::Sprite &sprite);
 
@@ -3,8 +3,15 @@
 namespace fck
 {
 
-SystemBase::SystemBase(const ComponentsFilter &components_filter)
-    : m_components_filter{components_filter}, m_world{nullptr}
+const uint32_t NULL_ENTITY_POSITION = std::numeric_limits<uint32_t>::max();
+
+SystemBase::SystemBase(const ComponentsFilter &components_filter, MembershipOrder membership_order)
+    : m_world{nullptr},
+      m_component_storage{nullptr},
+      m_components_filter{components_filter},
+      m_membership_order{membership_order},
+      m_exclusive{true},
+      m_removed_count{0}
 {
 }
 
@@ -18,11 +25,41 @@ const ComponentsFilter &SystemBase::getComponentsFilter() const
     return m_components_filter;
 }
 
+MembershipOrder SystemBase::getMembershipOrder() const
+{
+    return m_membership_order;
+}
+
 std::vector<Entity> &SystemBase::getEntities()
 {
     return m_entities;
 }
 
+const ComponentsFilter &SystemBase::getReadFilter() const
+{
+    return m_read_filter;
+}
+
+const ComponentsFilter &SystemBase::getWriteFilter() const
+{
+    return m_write_filter;
+}
+
+bool SystemBase::isExclusive() const
+{
+    return m_exclusive;
+}
+
+CommandBuffer &SystemBase::getCommandBuffer()
+{
+    return m_command_buffer;
+}
+
+void SystemBase::setExclusive(bool exclusive)
+{
+    m_exclusive = exclusive;
+}
+
 void SystemBase::initialize()
 {
 }
@@ -37,20 +74,101 @@ void SystemBase::onEntityRemoved(Entity &entity)
     (void)(entity);
 }
 
+void SystemBase::onEntitiesAdded(std::vector<Entity> &entities)
+{
+    for (Entity &entity : entities)
+        onEntityAdded(entity);
+}
+
 void SystemBase::addEntity(Entity &entity)
 {
+    uint32_t index = entity.getId().getIndex();
+    if (m_entity_positions.size() <= index)
+        m_entity_positions.resize(index + 1, NULL_ENTITY_POSITION);
+
+    if (m_entity_positions[index] != NULL_ENTITY_POSITION)
+        return;
+
+    m_entity_positions[index] = m_entities.size();
     m_entities.push_back(entity);
     onEntityAdded(entity);
 }
 
+void SystemBase::addEntities(std::vector<Entity> &entities)
+{
+    std::vector<Entity> added_entities;
+    added_entities.reserve(entities.size());
+
+    for (Entity &entity : entities)
+    {
+        uint32_t index = entity.getId().getIndex();
+        if (m_entity_positions.size() <= index)
+            m_entity_positions.resize(index + 1, NULL_ENTITY_POSITION);
+
+        if (m_entity_positions[index] != NULL_ENTITY_POSITION)
+            continue;
+
+        m_entity_positions[index] = m_entities.size();
+        m_entities.push_back(entity);
+        added_entities.push_back(entity);
+    }
+
+    if (!added_entities.empty())
+        onEntitiesAdded(added_entities);
+}
+
 void SystemBase::removeEntity(Entity &entity)
 {
-    auto entity_found = std::find(m_entities.begin(), m_entities.end(), entity);
-    if (entity_found != m_entities.end())
+    uint32_t index = entity.getId().getIndex();
+    if (m_entity_positions.size() <= index || m_entity_positions[index] == NULL_ENTITY_POSITION)
+        return;
+
+    uint32_t position = m_entity_positions[index];
+    m_entity_positions[index] = NULL_ENTITY_POSITION;
+
+    if (m_membership_order == MembershipOrder::STABLE)
+    {
+        // Null entity is left in place until compactEntities
+        m_entities[position] = Entity{};
+        ++m_removed_count;
+    }
+    else
+    {
+        if (position != m_entities.size() - 1)
+        {
+            m_entities[position] = m_entities.back();
+            m_entity_positions[m_entities[position].getId().getIndex()] = position;
+        }
+        m_entities.pop_back();
+    }
+
+    onEntityRemoved(entity);
+}
+
+void SystemBase::removeAllEntities()
+{
+    m_entities.clear();
+    m_entity_positions.clear();
+    m_removed_count = 0;
+}
+
+void SystemBase::compactEntities()
+{
+    if (m_removed_count == 0)
+        return;
+
+    uint32_t position = 0;
+    for (const Entity &entity : m_entities)
     {
-        m_entities.erase(entity_found);
-        onEntityRemoved(entity);
+        if (!entity.isValid())
+            continue;
+
+        m_entity_positions[entity.getId().getIndex()] = position;
+        m_entities[position++] = entity;
     }
+
+    m_entities.resize(position);
+    m_removed_count = 0;
 }
 
 } // namespace fck
@@ -1,10 +1,11 @@
 #ifndef SYSTEM_MQDYZLTQPLIE_H
 #define SYSTEM_MQDYZLTQPLIE_H
 
+#include "command_buffer.h"
 #include "component.h"
 #include "entity.h"
+#include "view.h"
 
-#include <functional>
 #include <vector>
 
 namespace fck
@@ -12,77 +13,121 @@ namespace fck
 
 class World;
 
+// Order of system entities after removing one of them
+enum class MembershipOrder
+{
+    UNORDERED, // last entity takes place of removed one
+    STABLE // entities keep order they were added in, removed ones are compacted in World::refresh
+};
+// Systems whose result doesn't depend on order of their entities opt into UNORDERED
+
 class SystemBase
 {
     friend class World;
 
 public:
-    SystemBase(const ComponentsFilter &components_filter);
+    SystemBase(
+        const ComponentsFilter &components_filter,
+        MembershipOrder membership_order = MembershipOrder::STABLE);
     virtual ~SystemBase() = default;
 
     World *getWorld() const;
     const ComponentsFilter &getComponentsFilter() const;
+    MembershipOrder getMembershipOrder() const;
     std::vector<Entity> &getEntities();
 
-    void each(const std::function<void(Entity &)> &callback)
-    {
-        if (callback)
-        {
-            auto it = m_entities.begin();
-            while (it != m_entities.end())
-            {
-                callback(*it);
-                ++it;
-            }
-        }
-    }
+    // Components the system reads and writes, on any entity. Exclusive systems touch
+    // something else (signals, scripts, shared objects) and never run concurrently.
+    const ComponentsFilter &getReadFilter() const;
+    const ComponentsFilter &getWriteFilter() const;
+    bool isExclusive() const;
 
-    template<typename T>
-    struct EachCallbackType
-    {
-        using type = T;
-    };
-    template<typename... Args>
-    void each(
-        const std::function<void(Entity &, typename EachCallbackType<Args &>::type...)> &callback)
-    {
-        if (callback)
-        {
-            auto it = m_entities.begin();
-            while (it != m_entities.end())
-            {
-                callback(*it, (*it).get<Args>()...);
-                ++it;
-            }
-        }
-    }
+    // Structural changes made during update, applied in World::refresh
+    CommandBuffer &getCommandBuffer();
+
+    template<typename... Ts>
+    View<Ts...> view();
+
+    template<typename... Ts, typename Callback>
+    void each(Callback &&callback);
 
 protected:
+    template<typename... Ts>
+    void reads();
+
+    template<typename... Ts>
+    void writes();
+
+    void setExclusive(bool exclusive);
+
     virtual void initialize();
     virtual void onEntityAdded(Entity &entity);
     virtual void onEntityRemoved(Entity &entity);
+    // Entities added at once, calls onEntityAdded for each of them by default
+    virtual void onEntitiesAdded(std::vector<Entity> &entities);
 
 private:
     void setScene(World *scene);
     void addEntity(Entity &entity);
+    void addEntities(std::vector<Entity> &entities);
     void removeEntity(Entity &entity);
+    void removeAllEntities();
+    // Drops entities removed from STABLE system at once, keeping order of others
+    void compactEntities();
 
 private:
     World *m_world;
+    ComponentStorage *m_component_storage;
     ComponentsFilter m_components_filter;
+    MembershipOrder m_membership_order;
+    ComponentsFilter m_read_filter;
+    ComponentsFilter m_write_filter;
+    bool m_exclusive;
+    CommandBuffer m_command_buffer;
     std::vector<Entity> m_entities;
+    // Position in m_entities by entity index
+    std::vector<uint32_t> m_entity_positions;
+    uint32_t m_removed_count;
 };
 
 template<typename... Args>
 class System : public SystemBase
 {
 public:
-    System() : SystemBase{ComponentsFilter::create<Args...>()}
+    System(MembershipOrder membership_order = MembershipOrder::STABLE)
+        : SystemBase{ComponentsFilter::create<Args...>(), membership_order}
     {
     }
     ~System() = default;
 };
 
+template<typename... Ts>
+void SystemBase::reads()
+{
+    m_read_filter.filter |= ComponentsFilter::create<Ts...>().filter;
+}
+
+template<typename... Ts>
+void SystemBase::writes()
+{
+    m_write_filter.filter |= ComponentsFilter::create<Ts...>().filter;
+}
+
+template<typename... Ts>
+View<Ts...> SystemBase::view()
+{
+    fck_assert(
+        m_components_filter.test(ComponentsFilter::create<Ts...>()),
+        "View components are not part of system filter");
+    return View<Ts...>{*m_component_storage, m_entities};
+}
+
+template<typename... Ts, typename Callback>
+void SystemBase::each(Callback &&callback)
+{
+    view<Ts...>().each(std::forward<Callback>(callback));
+}
+
 template<class T>
 TypeId systemTypeId()
 {
@@ -0,0 +1,128 @@
+#include "system_scheduler.h"
+#include "profiler.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+namespace fck
+{
+
+SystemScheduler::SystemScheduler(int32_t threads_count) : m_thread_pool{threads_count}
+{
+}
+
+void SystemScheduler::addSystem(
+    SystemBase &system, const std::function<void(const sf::Time &)> &update, const char *name)
+{
+    Entry entry{&system, update, {}, 0};
+    for (int32_t i = 0; i < int32_t(m_entries.size()); ++i)
+    {
+        if (!isConflicting(*m_entries[i].system, system))
+            continue;
+
+        entry.dependencies.push_back(i);
+        entry.stage = std::max(entry.stage, m_entries[i].stage + 1);
+    }
+
+    if (entry.stage >= m_stages.size())
+        m_stages.resize(entry.stage + 1);
+
+    m_stages[entry.stage].push_back(m_entries.size());
+    m_entries.push_back(std::move(entry));
+    m_system_times.push_back({name, 0});
+}
+
+void SystemScheduler::clear()
+{
+    m_entries.clear();
+    m_stages.clear();
+    m_system_times.clear();
+}
+
+void SystemScheduler::update(const sf::Time &elapsed)
+{
+    for (const std::vector<int32_t> &stage : m_stages)
+    {
+        if (stage.size() == 1)
+        {
+            updateEntry(stage.front(), elapsed);
+            continue;
+        }
+
+        m_tasks.clear();
+        for (int32_t entry_index : stage)
+            m_tasks.push_back(
+                [this, entry_index, &elapsed]() { updateEntry(entry_index, elapsed); });
+
+        m_thread_pool.run(m_tasks);
+    }
+}
+
+ThreadPool &SystemScheduler::getThreadPool()
+{
+    return m_thread_pool;
+}
+
+int32_t SystemScheduler::getStagesCount() const
+{
+    return m_stages.size();
+}
+
+void SystemScheduler::logStages() const
+{
+    for (int32_t i = 0; i < int32_t(m_stages.size()); ++i)
+    {
+        for (int32_t entry_index : m_stages[i])
+        {
+            std::string dependency_names;
+            for (int32_t dependency : m_entries[entry_index].dependencies)
+            {
+                if (!dependency_names.empty())
+                    dependency_names += ", ";
+                dependency_names += m_system_times[dependency].name;
+            }
+
+            spdlog::info(
+                "Stage {}: {}{}, after: {}",
+                i,
+                m_system_times[entry_index].name,
+                m_entries[entry_index].system->isExclusive() ? " (exclusive)" : "",
+                dependency_names);
+        }
+    }
+}
+
+const std::vector<SystemScheduler::SystemTime> &SystemScheduler::getSystemTimes() const
+{
+    return m_system_times;
+}
+
+bool SystemScheduler::isConflicting(const SystemBase &first, const SystemBase &second)
+{
+    if (first.isExclusive() || second.isExclusive())
+        return true;
+
+    uint64_t first_access = first.getReadFilter().filter | first.getWriteFilter().filter;
+    uint64_t second_access = second.getReadFilter().filter | second.getWriteFilter().filter;
+
+    return (first.getWriteFilter().filter & second_access)
+           || (second.getWriteFilter().filter & first_access);
+}
+
+void SystemScheduler::updateEntry(int32_t entry_index, const sf::Time &elapsed)
+{
+    SystemBase &system = *m_entries[entry_index].system;
+
+    // Signals and calls of non-exclusive system are deferred to its buffer
+    if (!system.isExclusive())
+        CommandBuffer::setCurrent(&system.getCommandBuffer());
+
+    int64_t begin = Profiler::now();
+    m_entries[entry_index].update(elapsed);
+    m_system_times[entry_index].time = double(Profiler::now() - begin) / 1000000;
+
+    CommandBuffer::setCurrent(nullptr);
+}
+
+} // namespace fck
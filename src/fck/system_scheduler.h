@@ -0,0 +1,74 @@
+#ifndef SYSTEMSCHEDULER_RBVKTUQNZSWE_H
+#define SYSTEMSCHEDULER_RBVKTUQNZSWE_H
+
+#include "system.h"
+#include "thread_pool.h"
+
+#include <SFML/System/Time.hpp>
+
+#include <functional>
+#include <vector>
+
+namespace fck
+{
+
+// Runs system updates in stages. Systems registered before a system and conflicting with it
+// are its dependencies, the system goes to the stage after the last of them (longest path in
+// dependency graph). Conflicting systems keep registration order, systems within one stage
+// run concurrently on the thread pool.
+class SystemScheduler
+{
+public:
+    struct SystemTime
+    {
+        const char *name;
+        double time; // ms of last update
+    };
+
+    explicit SystemScheduler(int32_t threads_count = ThreadPool::defaultThreadsCount());
+    ~SystemScheduler() = default;
+
+    // Name must outlive scheduler, string literals are fine
+    void addSystem(
+        SystemBase &system,
+        const std::function<void(const sf::Time &)> &update,
+        const char *name = "");
+    void clear();
+
+    void update(const sf::Time &elapsed);
+
+    // Shared by systems for their own parallel work
+    ThreadPool &getThreadPool();
+
+    int32_t getStagesCount() const;
+    // Writes systems of every stage and their dependencies to log
+    void logStages() const;
+    // In order systems were added, measured apart from profiler so they are never lost
+    const std::vector<SystemTime> &getSystemTimes() const;
+
+private:
+    static bool isConflicting(const SystemBase &first, const SystemBase &second);
+
+    void updateEntry(int32_t entry_index, const sf::Time &elapsed);
+
+private:
+    struct Entry
+    {
+        SystemBase *system;
+        std::function<void(const sf::Time &)> update;
+        std::vector<int32_t> dependencies;
+        int32_t stage;
+    };
+
+    std::vector<Entry> m_entries;
+    std::vector<std::vector<int32_t>> m_stages;
+    // Every entry writes only its own time
+    std::vector<SystemTime> m_system_times;
+
+    ThreadPool m_thread_pool;
+    std::vector<std::function<void()>> m_tasks;
+};
+
+} // namespace fck
+
+#endif // SYSTEMSCHEDULER_RBVKTUQNZSWE_H
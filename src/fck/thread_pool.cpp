@@ -0,0 +1,117 @@
+#include "thread_pool.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <exception>
+
+namespace fck
+{
+
+ThreadPool::ThreadPool(int32_t threads_count)
+    : m_tasks{nullptr}, m_next_task{0}, m_unfinished_tasks{0}, m_stopped{false}
+{
+    for (int32_t i = 0; i < threads_count; ++i)
+        m_threads.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stopped = true;
+    }
+
+    m_task_condition.notify_all();
+
+    for (std::thread &thread : m_threads)
+        thread.join();
+}
+
+void ThreadPool::run(const std::vector<std::function<void()>> &tasks)
+{
+    if (tasks.empty())
+        return;
+
+    std::unique_lock<std::mutex> lock{m_mutex};
+
+    if (m_tasks)
+    {
+        lock.unlock();
+        for (const std::function<void()> &task : tasks)
+            runTask(task);
+        return;
+    }
+
+    m_tasks = &tasks;
+    m_next_task = 0;
+    m_unfinished_tasks = tasks.size();
+
+    m_task_condition.notify_all();
+
+    // Calling thread takes part in work too
+    while (runNextTask(lock))
+    {
+    }
+
+    m_done_condition.wait(lock, [this]() { return m_unfinished_tasks == 0; });
+    m_tasks = nullptr;
+}
+
+int32_t ThreadPool::getThreadsCount() const
+{
+    return m_threads.size();
+}
+
+int32_t ThreadPool::defaultThreadsCount()
+{
+    return std::max(int32_t(std::thread::hardware_concurrency()) - 1, 0);
+}
+
+void ThreadPool::workerLoop()
+{
+    std::unique_lock<std::mutex> lock{m_mutex};
+
+    while (true)
+    {
+        m_task_condition.wait(lock, [this]() {
+            return m_stopped || (m_tasks && m_next_task < m_tasks->size());
+        });
+
+        if (m_stopped)
+            return;
+
+        runNextTask(lock);
+    }
+}
+
+bool ThreadPool::runNextTask(std::unique_lock<std::mutex> &lock)
+{
+    if (!m_tasks || m_next_task >= m_tasks->size())
+        return false;
+
+    const std::function<void()> &task = (*m_tasks)[m_next_task++];
+
+    lock.unlock();
+    runTask(task);
+    lock.lock();
+
+    if (--m_unfinished_tasks == 0)
+        m_done_condition.notify_all();
+
+    return true;
+}
+
+void ThreadPool::runTask(const std::function<void()> &task)
+{
+    try
+    {
+        task();
+    }
+    catch (const std::exception &e)
+    {
+        spdlog::error("Thread pool task failed: {}", e.what());
+    }
+}
+
+} // namespace fck
@@ -0,0 +1,54 @@
+#ifndef THREADPOOL_NHGQZWELMOXA_H
+#define THREADPOOL_NHGQZWELMOXA_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fck
+{
+
+// Fixed set of worker threads. run() hands tasks to workers and to the calling thread
+// and returns when all of them are done. Pool is shared, tasks run while pool is busy with
+// other tasks (nested run) are run by calling thread alone.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(int32_t threads_count = defaultThreadsCount());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool(ThreadPool &&) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    ThreadPool &operator=(ThreadPool &&) = delete;
+
+    void run(const std::vector<std::function<void()>> &tasks);
+
+    int32_t getThreadsCount() const;
+
+    static int32_t defaultThreadsCount();
+
+private:
+    void workerLoop();
+    bool runNextTask(std::unique_lock<std::mutex> &lock);
+    static void runTask(const std::function<void()> &task);
+
+private:
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_task_condition;
+    std::condition_variable m_done_condition;
+
+    const std::vector<std::function<void()>> *m_tasks;
+    std::size_t m_next_task;
+    std::size_t m_unfinished_tasks;
+    bool m_stopped;
+};
+
+} // namespace fck
+
+#endif // THREADPOOL_NHGQZWELMOXA_H
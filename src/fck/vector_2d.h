@@ -53,6 +53,11 @@ public:
         return m_data[index];
     }
 
+    const T &operator[](int32_t index) const
+    {
+        return m_data[index];
+    }
+
     const sf::Vector2i &getSize2D() const
     {
         return m_size;
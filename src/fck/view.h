@@ -0,0 +1,229 @@
+#ifndef VIEW_KXQMRBDTZHWA_H
+#define VIEW_KXQMRBDTZHWA_H
+
+#include "component.h"
+#include "component_storage.h"
+#include "entity.h"
+#include "id_storage.h"
+
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace fck
+{
+
+class World;
+
+// Typed iteration over entities with components Ts.
+// Callback is (Entity &, Ts &...) or (Ts &...) and takes components directly from pools.
+// System view walks entities of the system, world view walks the smallest pool backwards,
+// so removing components of the current entity inside callback is safe.
+// changed<Us...>(tick) and added<Us...>(tick) keep entities with any of Us changed or
+// added at tick or later.
+template<typename... Ts>
+class View
+{
+public:
+    View(ComponentStorage &component_storage, std::vector<Entity> &entities);
+    View(ComponentStorage &component_storage, const IdStorage &id_storage, World *world);
+    ~View() = default;
+
+    template<typename... Us>
+    View &without();
+
+    template<typename... Us>
+    View &changed(uint32_t tick);
+
+    template<typename... Us>
+    View &added(uint32_t tick);
+
+    template<typename Callback>
+    void each(Callback &&callback);
+
+private:
+    template<typename Callback>
+    void invoke(Callback &callback, Entity &entity, uint32_t index);
+
+    struct TickFilter
+    {
+        bool enabled = false;
+        uint32_t tick = 0;
+        std::vector<const ComponentPoolBase *> pools;
+    };
+
+    template<typename... Us>
+    void setTickFilter(TickFilter &tick_filter, uint32_t tick);
+
+    bool isExcluded(uint32_t index) const;
+    bool isTickMatched(uint32_t index) const;
+    bool hasAll(uint32_t index) const;
+    const ComponentPoolBase *getSmallestPool() const;
+
+private:
+    ComponentStorage *m_component_storage;
+    std::vector<Entity> *m_entities;
+    const IdStorage *m_id_storage;
+    World *m_world;
+
+    std::tuple<ComponentPool<Ts> *...> m_pools;
+    ComponentsFilter m_excluded_filter;
+    TickFilter m_changed_filter;
+    TickFilter m_added_filter;
+};
+
+template<typename... Ts>
+View<Ts...>::View(ComponentStorage &component_storage, std::vector<Entity> &entities)
+    : m_component_storage{&component_storage},
+      m_entities{&entities},
+      m_id_storage{nullptr},
+      m_world{nullptr},
+      m_pools{component_storage.findPool<Ts>()...}
+{
+}
+
+template<typename... Ts>
+View<Ts...>::View(ComponentStorage &component_storage, const IdStorage &id_storage, World *world)
+    : m_component_storage{&component_storage},
+      m_entities{nullptr},
+      m_id_storage{&id_storage},
+      m_world{world},
+      m_pools{component_storage.findPool<Ts>()...}
+{
+}
+
+template<typename... Ts>
+template<typename... Us>
+View<Ts...> &View<Ts...>::without()
+{
+    m_excluded_filter.filter |= ComponentsFilter::create<Us...>().filter;
+    return *this;
+}
+
+template<typename... Ts>
+template<typename... Us>
+View<Ts...> &View<Ts...>::changed(uint32_t tick)
+{
+    setTickFilter<Us...>(m_changed_filter, tick);
+    return *this;
+}
+
+template<typename... Ts>
+template<typename... Us>
+View<Ts...> &View<Ts...>::added(uint32_t tick)
+{
+    setTickFilter<Us...>(m_added_filter, tick);
+    return *this;
+}
+
+template<typename... Ts>
+template<typename Callback>
+void View<Ts...>::each(Callback &&callback)
+{
+    if (m_entities)
+    {
+        for (Entity &entity : *m_entities)
+        {
+            // Components can be removed by callback of other entity before system is updated
+            uint32_t index = entity.getId().getIndex();
+            if (hasAll(index) && !isExcluded(index) && isTickMatched(index))
+                invoke(callback, entity, index);
+        }
+        return;
+    }
+
+    if constexpr (sizeof...(Ts) > 0)
+    {
+        if (!(std::get<ComponentPool<Ts> *>(m_pools) && ...))
+            return;
+
+        const std::vector<uint32_t> &indexes = getSmallestPool()->getEntityIndexes();
+        for (uint32_t i = indexes.size(); i > 0; --i)
+        {
+            if (i > indexes.size())
+                continue;
+
+            uint32_t index = indexes[i - 1];
+            if (!hasAll(index) || isExcluded(index) || !isTickMatched(index))
+                continue;
+
+            Entity entity{m_id_storage->get(index), m_world};
+            invoke(callback, entity, index);
+        }
+    }
+}
+
+template<typename... Ts>
+template<typename Callback>
+void View<Ts...>::invoke(Callback &callback, Entity &entity, uint32_t index)
+{
+    if constexpr (std::is_invocable_v<Callback &, Entity &, Ts &...>)
+        callback(entity, std::get<ComponentPool<Ts> *>(m_pools)->get(index)...);
+    else
+        callback(std::get<ComponentPool<Ts> *>(m_pools)->get(index)...);
+}
+
+template<typename... Ts>
+template<typename... Us>
+void View<Ts...>::setTickFilter(TickFilter &tick_filter, uint32_t tick)
+{
+    tick_filter.enabled = true;
+    tick_filter.tick = tick;
+    tick_filter.pools = {m_component_storage->findPool<Us>()...};
+}
+
+template<typename... Ts>
+bool View<Ts...>::isTickMatched(uint32_t index) const
+{
+    auto matched = [index](const TickFilter &tick_filter, bool added) {
+        if (!tick_filter.enabled)
+            return true;
+
+        for (const ComponentPoolBase *pool : tick_filter.pools)
+        {
+            if (!pool || !pool->has(index))
+                continue;
+
+            uint32_t tick = added ? pool->getAddedTick(index) : pool->getChangedTick(index);
+            if (tick >= tick_filter.tick)
+                return true;
+        }
+
+        return false;
+    };
+
+    return matched(m_changed_filter, false) && matched(m_added_filter, true);
+}
+
+template<typename... Ts>
+bool View<Ts...>::isExcluded(uint32_t index) const
+{
+    return m_excluded_filter.filter
+           && (m_component_storage->getComponentsFilter(index).filter & m_excluded_filter.filter);
+}
+
+template<typename... Ts>
+bool View<Ts...>::hasAll(uint32_t index) const
+{
+    return (
+        (std::get<ComponentPool<Ts> *>(m_pools)
+         && std::get<ComponentPool<Ts> *>(m_pools)->has(index))
+        && ...);
+}
+
+template<typename... Ts>
+const ComponentPoolBase *View<Ts...>::getSmallestPool() const
+{
+    const ComponentPoolBase *smallest = nullptr;
+    (
+        [&](const ComponentPoolBase *pool) {
+            if (!smallest || pool->size() < smallest->size())
+                smallest = pool;
+        }(std::get<ComponentPool<Ts> *>(m_pools)),
+        ...);
+    return smallest;
+}
+
+} // namespace fck
+
+#endif // VIEW_KXQMRBDTZHWA_H
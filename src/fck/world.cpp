@@ -1,10 +1,15 @@
 #include "world.h"
 #include "common.h"
+#include "profiler.h"
+#include "snapshot.h"
 #include "utilities.h"
 
 namespace fck
 {
 
+const uint32_t SNAPSHOT_MAGIC = 0x57434b46; // FCKW
+const uint32_t SNAPSHOT_VERSION = 1;
+
 template<class T>
 void ensureCapacity(T &container, typename T::size_type index)
 {
@@ -20,12 +25,31 @@ World::~World()
 {
 }
 
+void World::reserve(int32_t size)
+{
+    if (size > m_entity_id_storage.size())
+        resize(size);
+
+    m_entity_cache.alive.reserve(size);
+}
+
+IdReusePolicy World::getIdReusePolicy() const
+{
+    return m_entity_id_storage.getReusePolicy();
+}
+
+void World::setIdReusePolicy(IdReusePolicy id_reuse_policy)
+{
+    m_entity_id_storage.setReusePolicy(id_reuse_policy);
+}
+
 void World::removeAllSystems()
 {
     for (auto &it : m_systems)
-        it.second->m_entities.clear();
+        it.second->removeAllEntities();
 
     m_systems.clear();
+    m_ordered_systems.clear();
 }
 
 Entity World::createEntity()
@@ -43,9 +67,9 @@ std::vector<Entity> World::createEntities(int32_t size)
 
     checkForResize(size);
 
-    for (int32_t i = 0; i < size; ++i)
+    for (const Id &id : m_entity_id_storage.createMany(size))
     {
-        Entity e{m_entity_id_storage.create(), this};
+        Entity e{id, this};
         m_entity_cache.alive.push_back(e);
         entities.push_back(e);
     }
@@ -121,8 +145,164 @@ bool World::isValid(const Entity &entity) const
     return m_entity_id_storage.isValid(entity.getId());
 }
 
+CommandBuffer &World::getCommandBuffer()
+{
+    return m_command_buffer;
+}
+
+uint32_t World::getTick() const
+{
+    return m_entity_attributes.component_storage.getTick();
+}
+
+uint32_t World::nextTick()
+{
+    return m_entity_attributes.component_storage.nextTick();
+}
+
+std::vector<char> World::saveSnapshot()
+{
+    std::vector<char> data;
+    SnapshotWriter writer{data};
+
+    writer.write(SNAPSHOT_MAGIC);
+    writer.write(SNAPSHOT_VERSION);
+
+    m_entity_id_storage.save(writer);
+
+    writer.write(uint32_t(m_entity_cache.alive.size()));
+    for (const Entity &entity : m_entity_cache.alive)
+    {
+        writer.writeEntity(entity);
+        writer.write(uint8_t(isEnabled(entity)));
+    }
+
+    const std::vector<ComponentSerializer::Serializer> &serializers
+        = ComponentSerializer::getSerializers();
+
+    writer.write(uint32_t(serializers.size()));
+    for (const ComponentSerializer::Serializer &serializer : serializers)
+    {
+        writer.writeString(serializer.name);
+
+        // Size of components data lets restore skip types it has no serializer for
+        std::size_t size_position = writer.getPosition();
+        writer.write(uint64_t(0));
+
+        std::size_t count_position = writer.getPosition();
+        writer.write(uint32_t(0));
+
+        uint32_t count = serializer.save(writer, m_entity_attributes.component_storage);
+
+        writer.writeAt(count_position, count);
+        writer.writeAt(size_position, uint64_t(writer.getPosition() - count_position));
+    }
+
+    return data;
+}
+
+bool World::restoreSnapshot(const std::vector<char> &data)
+{
+    SnapshotReader reader{data, this};
+
+    try
+    {
+        fck_assert(reader.read<uint32_t>() == SNAPSHOT_MAGIC, "Data is not a world snapshot");
+        fck_assert(
+            reader.read<uint32_t>() == SNAPSHOT_VERSION, "Unsupported world snapshot version");
+
+        resetEntities();
+
+        m_entity_id_storage.restore(reader);
+        m_entity_attributes.resize(m_entity_id_storage.size());
+
+        uint32_t entities_count = reader.read<uint32_t>();
+        m_entity_cache.alive.reserve(entities_count);
+
+        std::vector<Entity> enabled_entities;
+        for (uint32_t i = 0; i < entities_count; ++i)
+        {
+            Entity entity = reader.readEntity();
+            fck_assert(isValid(entity), "Invalid entity in world snapshot");
+
+            m_entity_cache.alive.push_back(entity);
+            if (reader.read<uint8_t>())
+                enabled_entities.push_back(entity);
+        }
+
+        uint32_t pools_count = reader.read<uint32_t>();
+        for (uint32_t i = 0; i < pools_count; ++i)
+        {
+            std::string name = reader.readString();
+            uint64_t size = reader.read<uint64_t>();
+
+            const ComponentSerializer::Serializer *serializer
+                = ComponentSerializer::findSerializer(name);
+            if (!serializer)
+            {
+                spdlog::warn("Component serializer not found: {}", name);
+                reader.skip(size);
+                continue;
+            }
+
+            uint32_t count = reader.read<uint32_t>();
+            serializer->restore(reader, m_entity_attributes.component_storage, count);
+        }
+
+        for (const Entity &entity : enabled_entities)
+            m_entity_attributes.attributes[entity.getId().getIndex()].enabled = true;
+
+        // Every system gets all its entities at once
+        for (auto &it : m_systems)
+        {
+            uint64_t system_index = it.first;
+
+            std::vector<Entity> system_entities;
+            for (const Entity &entity : enabled_entities)
+            {
+                uint32_t index = entity.getId().getIndex();
+
+                ComponentsFilter components_filter
+                    = m_entity_attributes.component_storage.getComponentsFilter(index);
+                if (!components_filter.test(it.second->getComponentsFilter()))
+                    continue;
+
+                auto &attribute = m_entity_attributes.attributes[index];
+                ensureCapacity(attribute.systems, system_index);
+                attribute.systems[system_index] = true;
+
+                system_entities.push_back(entity);
+            }
+
+            it.second->addEntities(system_entities);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        spdlog::warn("Can't restore world snapshot: {}", e.what());
+        resetEntities();
+        return false;
+    }
+
+    for (const Entity &entity : m_entity_cache.alive)
+    {
+        if (isEnabled(entity))
+            entity_enabled(entity);
+    }
+
+    return true;
+}
+
 void World::refresh()
 {
+    FCK_PROFILE_ZONE("World::refresh");
+
+    nextTick();
+
+    m_command_buffer.execute(*this);
+    for (SystemBase *system : m_ordered_systems)
+        system->m_command_buffer.execute(*this);
+
     // go through all the activated entities from last call to refresh
     for (auto &entity : m_entity_cache.enabled)
     {
@@ -132,14 +312,16 @@ void World::refresh()
         auto &attribute = m_entity_attributes.attributes[entity.getId().getIndex()];
         attribute.enabled = true;
 
+        ComponentsFilter components_filter
+            = m_entity_attributes.component_storage.getComponentsFilter(entity.getId().getIndex());
+
         // loop through all the systems within the scene
         for (auto &it : m_systems)
         {
             uint64_t system_index = it.first;
 
             // if the entity passes the filter the system has and is not already part of the system
-            if (m_entity_attributes.component_storage.getComponentsFilter(entity).test(
-                    it.second->getComponentsFilter()))
+            if (components_filter.test(it.second->getComponentsFilter()))
             {
                 if (attribute.systems.size() <= system_index || !attribute.systems[system_index])
                 {
@@ -154,8 +336,6 @@ void World::refresh()
                 attribute.systems[system_index] = false;
             }
         }
-
-        entity_enabled(entity);
     }
 
     // go through all the deactivated entities from last call to refresh
@@ -181,8 +361,22 @@ void World::refresh()
                 attribute.systems[system_index] = false;
             }
         }
+    }
+
+    // Systems are compacted before signals, so slots see no removed entities
+    for (SystemBase *system : m_ordered_systems)
+        system->compactEntities();
 
-        entity_disabled(entity);
+    for (auto &entity : m_entity_cache.enabled)
+    {
+        if (entity.isValid())
+            entity_enabled(entity);
+    }
+
+    for (auto &entity : m_entity_cache.disabled)
+    {
+        if (entity.isValid())
+            entity_disabled(entity);
     }
 
     // go through all the killed entities from last call to refresh
@@ -193,14 +387,14 @@ void World::refresh()
 
         entity_destroyed(entity);
 
-        m_entity_cache.alive.erase(
-            std::remove(m_entity_cache.alive.begin(), m_entity_cache.alive.end(), entity),
-            m_entity_cache.alive.end());
-
-        m_entity_attributes.component_storage.removeAll(entity);
+        m_entity_attributes.component_storage.removeAll(entity.getId().getIndex());
         m_entity_id_storage.destroy(entity.getId());
     }
 
+    // Destroyed entities aren't valid any more, alive ones keep their order
+    if (!m_entity_cache.destroyed.empty())
+        std::erase_if(m_entity_cache.alive, [](const Entity &entity) { return !entity.isValid(); });
+
     m_entity_cache.clearTemp();
 }
 
@@ -211,6 +405,7 @@ void World::clear()
     m_entity_attributes.clear();
     m_entity_cache.clear();
     m_entity_id_storage.clear();
+    m_command_buffer.clear();
 }
 
 void World::addSystem(SystemBase &system, TypeId system_type_id)
@@ -221,15 +416,19 @@ void World::addSystem(SystemBase &system, TypeId system_type_id)
         "System of this type is already contained within the world");
 
     m_systems[system_type_id].reset(&system);
+    m_ordered_systems.push_back(&system);
 
     system.m_world = this;
+    system.m_component_storage = &m_entity_attributes.component_storage;
     system.initialize();
 }
 
 void World::removeSystem(TypeId system_type_id)
 {
     fck_assert(systemExist(system_type_id), "System does not exist in world");
-    m_systems[system_type_id]->m_entities.clear();
+    m_systems[system_type_id]->removeAllEntities();
+    m_ordered_systems.erase(std::find(
+        m_ordered_systems.begin(), m_ordered_systems.end(), m_systems[system_type_id].get()));
     m_systems.erase(system_type_id);
 }
 
@@ -242,7 +441,7 @@ void World::checkForResize(int32_t size)
 {
     auto new_size = getEntityCount() + size;
     if (new_size > m_entity_id_storage.size())
-        resize(new_size);
+        resize(std::max(new_size, m_entity_id_storage.size() * 2));
 }
 
 void World::resize(int32_t size)
@@ -251,4 +450,22 @@ void World::resize(int32_t size)
     m_entity_attributes.resize(size);
 }
 
+void World::resetEntities()
+{
+    for (SystemBase *system : m_ordered_systems)
+    {
+        std::vector<Entity> entities = system->m_entities;
+        for (Entity &entity : entities)
+            system->removeEntity(entity);
+        system->compactEntities();
+
+        system->m_command_buffer.clear();
+    }
+
+    m_command_buffer.clear();
+    m_entity_attributes.clear();
+    m_entity_cache.clear();
+    m_entity_id_storage.clear();
+}
+
 } // namespace fck
@@ -1,11 +1,14 @@
 #ifndef WORLD_SJTWXYDCLHBB_H
 #define WORLD_SJTWXYDCLHBB_H
 
-#include "../sigslot/signal.hpp"
+#include "command_buffer.h"
 #include "component_storage.h"
 #include "entity.h"
 #include "id_storage.h"
+#include "inline_signal.h"
+#include "paged_vector.h"
 #include "system.h"
+#include "view.h"
 
 #include <unordered_map>
 #include <vector>
@@ -40,6 +43,14 @@ public:
 
     void removeAllSystems();
 
+    void reserve(int32_t size);
+
+    IdReusePolicy getIdReusePolicy() const;
+    void setIdReusePolicy(IdReusePolicy id_reuse_policy);
+
+    template<typename... Ts>
+    View<Ts...> view();
+
     Entity createEntity();
     std::vector<Entity> createEntities(int32_t size);
 
@@ -56,6 +67,19 @@ public:
     bool isEnabled(const Entity &entity) const;
     bool isValid(const Entity &entity) const;
 
+    CommandBuffer &getCommandBuffer();
+
+    // Tick of component changes, advances every refresh
+    uint32_t getTick() const;
+    uint32_t nextTick();
+
+    // Binary snapshot of ids, enabled entities and components of types with registered
+    // serializer. Should be taken after refresh. Restore replaces all entities and adds
+    // enabled ones to systems at once, membership follows from system filters. Components
+    // registered as not serialized are lost, restore warns about them.
+    std::vector<char> saveSnapshot();
+    bool restoreSnapshot(const std::vector<char> &data);
+
     void refresh();
     void clear();
 
@@ -67,10 +91,13 @@ private:
     void checkForResize(int32_t size);
     void resize(int32_t size);
 
+    // Removes entities from systems and drops them without signals
+    void resetEntities();
+
 public:
-    sigslot::signal<const Entity &> entity_enabled;
-    sigslot::signal<const Entity &> entity_disabled;
-    sigslot::signal<const Entity &> entity_destroyed;
+    InlineSignal<const Entity &> entity_enabled;
+    InlineSignal<const Entity &> entity_disabled;
+    InlineSignal<const Entity &> entity_destroyed;
 
 private:
     struct SystemDeleter
@@ -78,11 +105,16 @@ private:
         void operator()(SystemBase *system) const
         {
             system->m_world = nullptr;
-            system->m_entities.clear();
+            system->m_component_storage = nullptr;
+            system->removeAllEntities();
+            system->m_command_buffer.clear();
         }
     };
 
     std::unordered_map<TypeId, std::unique_ptr<SystemBase, SystemDeleter>> m_systems;
+    // Systems in order they were added, command buffers are executed in this order
+    std::vector<SystemBase *> m_ordered_systems;
+    CommandBuffer m_command_buffer;
     IdStorage m_entity_id_storage;
 
     struct EntityAttributes
@@ -110,7 +142,7 @@ private:
         }
 
         ComponentStorage component_storage;
-        std::vector<Attribute> attributes;
+        PagedVector<Attribute> attributes;
     } m_entity_attributes;
 
     struct EntityCache
@@ -143,6 +175,13 @@ void World::addSystem(T &system)
     addSystem(system, systemTypeId<T>());
 }
 
+template<typename... Ts>
+View<Ts...> World::view()
+{
+    static_assert(sizeof...(Ts) > 0, "View requires at least one component type");
+    return View<Ts...>{m_entity_attributes.component_storage, m_entity_id_storage, this};
+}
+
 template<typename T>
 void World::removeSystem()
 {
@@ -38,6 +38,8 @@ enum Action
 {
     TOGGLE_RENDER_DEBUG = 10000,
     TOOGLE_COLLISION_DEBUG = 10001,
+    TOGGLE_PROFILER = 10002,
+    EXPORT_PROFILER_TRACE = 10003,
 
     BACK = 12000,
 
@@ -6,6 +6,7 @@
 #include "entity_funcs.h"
 #include "fck/clipping.h"
 #include "fck/event_dispatcher.h"
+#include "fck/random.h"
 #include "fck/resource_cache.h"
 #include "fck/sprite_animation.h"
 #include "fck/task_sequence.h"
@@ -21,6 +22,7 @@
 
 #include <algorithm>
 #include <filesystem>
+#include <random>
 
 namespace fck
 {
@@ -33,7 +35,8 @@ FckGame::FckGame()
       m_render_system{&m_render_tree},
       m_scene_system{&m_scene_tree},
       m_look_around_system{&m_scene_tree},
-      m_render_debug{false}
+      m_render_debug{false},
+      m_render_profiler{false}
 {
     m_event_handler = std::make_unique<EventHandler>(
         std::vector<int32_t>{
@@ -44,6 +47,11 @@ FckGame::FckGame()
         std::bind(
             static_cast<void (FckGame::*)(Event *)>(&FckGame::event), this, std::placeholders::_1));
 
+    auto settings = Settings::getGlobal();
+    setHeadless(settings->headless);
+    setTicksLimit(settings->headless_ticks);
+    setRealTime(settings->headless_real_time);
+
     getRrenderWindow().setView(m_render_window_view);
 
     m_world.addSystem(m_render_system);
@@ -63,6 +71,45 @@ FckGame::FckGame()
     m_world.addSystem(m_skills_system);
     m_world.addSystem(m_damage_sysytem);
     m_world.addSystem(m_sound_system);
+    m_world.addSystem(m_transform_hierarchy_system);
+
+    // Update order, systems without conflicting components run concurrently
+    auto add_scheduled_system = [this](auto &system, const char *name) {
+        int32_t entities_counter = PerfCounters::registerCounter(
+            std::string{name} + " entities", PerfCounters::Type::GAUGE);
+
+        m_system_scheduler.addSystem(
+            system,
+            [&system, name, entities_counter](const sf::Time &elapsed) {
+                ProfileZone profile_zone{name};
+                PerfCounters::set(entities_counter, system.getEntities().size());
+                system.update(double(elapsed.asMilliseconds()) / 1000);
+            },
+            name);
+    };
+
+    add_scheduled_system(m_player_system, "system::Player");
+    add_scheduled_system(m_target_follow_system, "system::TargetFollow");
+    add_scheduled_system(m_look_around_system, "system::LookAround");
+    add_scheduled_system(m_script_system, "system::Script");
+    add_scheduled_system(m_skills_system, "system::Skills");
+    add_scheduled_system(m_damage_sysytem, "system::Damage");
+    add_scheduled_system(m_stats_system, "system::Stats");
+    add_scheduled_system(m_collision_system, "system::Collision");
+    add_scheduled_system(m_movement_system, "system::Movement");
+    add_scheduled_system(m_transform_hierarchy_system, "system::TransformHierarchy");
+    add_scheduled_system(m_view_movement_system, "system::ViewMovement");
+    m_system_scheduler.addSystem(
+        m_drawable_animation_system,
+        [this](const sf::Time &elapsed) {
+            FCK_PROFILE_ZONE("system::DrawableAnimation");
+            m_drawable_animation_system.update(elapsed);
+        },
+        "system::DrawableAnimation");
+    add_scheduled_system(m_render_system, "system::Render");
+    m_system_scheduler.logStages();
+
+    m_target_follow_system.setThreadPool(&m_system_scheduler.getThreadPool());
 
     // world
     m_world.entity_enabled.connect(&system::Script::onEntityEnabled, &m_script_system);
@@ -80,21 +127,17 @@ FckGame::FckGame()
     });
 
     // transform
-    entity_funcs::moved.connect(&system::Scene::onEntityMoved, &m_scene_system);
-    entity_funcs::moved.connect(&system::Render::onEntityMoved, &m_render_system);
-    entity_funcs::moved.connect([this](const Entity &entity, const sf::Vector2f &) {
-        m_look_around_system.updateBounds(entity);
-    });
-    entity_funcs::moved.connect(&system::Script::onEntityMoved, &m_script_system);
-    entity_funcs::moved.connect(&system::Sound::onEntityMoved, &m_sound_system);
+    entity_funcs::moved.connect(&system::Scene::onEntitiesMoved, &m_scene_system);
+    entity_funcs::moved.connect(&system::Script::onEntitiesMoved, &m_script_system);
+    if (!isHeadless())
+        entity_funcs::moved.connect(&system::Sound::onEntitiesMoved, &m_sound_system);
+    entity_funcs::parent_changed.connect(
+        &system::TransformHierarchy::onEntityParentChanged, &m_transform_hierarchy_system);
 
     // state
     entity_funcs::state_changed.connect(&system::Script::onEntityStateChanged, &m_script_system);
     entity_funcs::direction_changed.connect(
         &system::Render::onEntityDirectionChanged, &m_render_system);
-    entity_funcs::direction_changed.connect([this](const Entity &entity, entity_state::Direction) {
-        m_look_around_system.updateBounds(entity);
-    });
     entity_funcs::direction_changed.connect(
         &system::Script::onEntityDirectionChanged, &m_script_system);
 
@@ -108,6 +151,13 @@ FckGame::FckGame()
     map_changed.connect(&system::TargetFollow::onMapChanged, &m_target_follow_system);
     map_changed.connect(&system::Script::onMapChanged, &m_script_system);
 
+    // input
+    m_input_actions.action_diactivated.connect(
+        &InputReplay<keyboard_action::Action>::onActionDiactivated, &m_input_replay);
+    m_input_replay.action_activated.connect(&system::Player::onActionActivated, &m_player_system);
+    m_input_replay.action_diactivated.connect(
+        &system::Player::onActionDiactivated, &m_player_system);
+
     // lua
     m_lua_state.open_libraries(sol::lib::base, sol::lib::coroutine, sol::lib::string, sol::lib::io);
     bindToLua(m_lua_state);
@@ -116,10 +166,24 @@ FckGame::FckGame()
     ScriptFactory::setSolState(&m_lua_state);
 }
 
+FckGame::~FckGame()
+{
+    // Static signals and factories would keep slots of systems and functions of lua state
+    entity_funcs::reset();
+    ScriptFactory::clear();
+    SkillFactory::clear();
+}
+
 void FckGame::init()
 {
     auto settings = Settings::getGlobal();
 
+    if (isHeadless())
+    {
+        initHeadless();
+        return;
+    }
+
     initFirstResources();
 
     sf::ContextSettings contex_settings;
@@ -170,6 +234,25 @@ void FckGame::init()
     first_loading_tasks->start();
 }
 
+void FckGame::initHeadless()
+{
+    // Textures, fonts and sounds need graphics context and audio device, drawables of
+    // entities are left empty
+    KnowledgeBase::loadSkillsFromDatabase(Settings::getGlobal()->resources_database_name);
+    KnowledgeBase::loadScriptsFromDatabase(Settings::getGlobal()->resources_database_name);
+    KnowledgeBase::loadEntitiesFromDatabase(Settings::getGlobal()->resources_database_name);
+
+    setupInputActions();
+
+    setState(game_state::MAIN_MENU);
+    newGame();
+}
+
+game_state::State FckGame::getState() const
+{
+    return m_state;
+}
+
 void FckGame::event(const sf::Event &e)
 {
     m_main_widget.event(e);
@@ -196,37 +279,52 @@ void FckGame::event(const sf::Event &e)
     }
 
     if (e.type == sf::Event::Closed)
-        exit();
+        exitGame();
 }
 
 void FckGame::update(const sf::Time &elapsed)
 {
+    FCK_PROFILE_ZONE("FckGame::update");
+
     EventDispatcher::update(elapsed);
 
     m_world.refresh();
 
     if (m_state == game_state::LEVEL)
     {
-        double delta_time = double(elapsed.asMilliseconds()) / 1000;
-
         m_visible_entities.clear();
 
-        m_player_system.update(delta_time);
-        m_target_follow_system.update(delta_time);
-
-        m_look_around_system.update(delta_time);
+        // Replayed actions of tick go before systems
+        m_input_replay.update();
+        if (m_input_replay.isFinished())
+        {
+            spdlog::info("Input replay finished");
+            m_input_replay.stop();
+            if (isHeadless())
+                exit();
+        }
 
-        m_script_system.update(delta_time);
+        if (m_stress_scenario && !m_stress_scenario->isFinished())
+        {
+            m_stress_scenario->update(m_player_entity, m_system_scheduler.getSystemTimes());
+            if (m_stress_scenario->isFinished())
+            {
+                m_stress_scenario->writeCsv(Settings::getGlobal()->stress_report_file_name);
+                if (isHeadless())
+                    exit();
+            }
+        }
 
-        m_skills_system.update(delta_time);
-        m_damage_sysytem.update(delta_time);
-        m_stats_system.update(delta_time);
+        m_system_scheduler.update(elapsed);
 
-        m_collision_system.update(delta_time);
-        m_movement_system.update(delta_time);
+        // Trees and listeners follow all moves of this tick at once
+        {
+            FCK_PROFILE_ZONE("entity_funcs::flushMoved");
+            entity_funcs::flushMoved();
+        }
 
-        m_view_movement_system.update(delta_time);
-        m_drawable_animation_system.update(elapsed);
+        if (isHeadless())
+            return;
 
         // Update visible entities
         sf::Vector2f view_pos = m_scene_view.getCenter();
@@ -251,6 +349,8 @@ void FckGame::update(const sf::Time &elapsed)
 
 void FckGame::draw(const sf::Time &elapsed)
 {
+    FCK_PROFILE_ZONE("FckGame::draw");
+
     // Draw scene
     m_scene_render_texture.clear();
     m_scene_render_texture.setView(m_scene_view);
@@ -341,6 +441,9 @@ void FckGame::draw(const sf::Time &elapsed)
     getRrenderWindow().draw(m_scene_render_sprite);
     getRrenderWindow().draw(m_main_widget);
 
+    if (m_render_profiler)
+        drawProfiler();
+
     getRrenderWindow().display();
 }
 
@@ -354,6 +457,10 @@ void FckGame::setState(game_state::State state)
 
     m_input_actions.action_activated.disconnect_all();
 
+    // No gui in headless mode, input of level comes only from replay
+    if (isHeadless())
+        return;
+
     switch (m_state)
     {
     case game_state::FIRST_LOADING: {
@@ -395,9 +502,7 @@ void FckGame::setState(game_state::State state)
 
         m_input_actions.action_activated.connect(&FckGame::onActionActivated, this);
         m_input_actions.action_activated.connect(
-            &system::Player::onActionActivated, &m_player_system);
-        m_input_actions.action_diactivated.connect(
-            &system::Player::onActionDiactivated, &m_player_system);
+            &InputReplay<keyboard_action::Action>::onActionActivated, &m_input_replay);
 
         break;
     }
@@ -532,6 +637,7 @@ void FckGame::loadSounds()
 
 void FckGame::exitGame()
 {
+    stopInputReplay();
     exit();
 }
 
@@ -541,17 +647,23 @@ void FckGame::newGame()
     loading_new_game_tasks->setTasks(
         {[this]() { setState(game_state::LOADING); },
          [this, loading_new_game_tasks]() {
-             gui::LoadingWidget *loading_widget
-                 = static_cast<gui::LoadingWidget *>(m_main_widget.getChildren().back());
-             loading_widget->setTotal(loading_new_game_tasks->getTasks().size() - 2);
-             loading_new_game_tasks->task_finished.connect(
-                 &gui::LoadingWidget::next, loading_widget);
+             if (!isHeadless())
+             {
+                 gui::LoadingWidget *loading_widget
+                     = static_cast<gui::LoadingWidget *>(m_main_widget.getChildren().back());
+                 loading_widget->setTotal(loading_new_game_tasks->getTasks().size() - 2);
+                 loading_new_game_tasks->task_finished.connect(
+                     &gui::LoadingWidget::next, loading_widget);
+             }
 
              //             m_level = std::make_unique<Level>(&m_world, &m_scene_tree);
              //             m_level->room_opened.connect(this, &FckGame::onLevelRoomOpened);
              //             m_level->room_enabled.connect(this, &FckGame::onLevelRoomEnabled);
              //             m_level->loadFromFile("resources/levels/l1.tmx");
 
+             // Seed is set before map generation, so replay gets same map
+             startInputReplay();
+
              map::Factory map_factory{&m_world, &m_scene_tree};
              m_map.reset(map_factory.createMap(30, "resources/levels/l1.tmx"));
 
@@ -585,6 +697,10 @@ void FckGame::newGame()
              entity_funcs::setDirection(kyoshi_2, entity_state::RIGHT);
              kyoshi_2.enable();
 
+             spawnEnemies(
+                 Settings::getGlobal()->level_enemy_name,
+                 Settings::getGlobal()->level_enemies_count);
+
              m_player_entity.enable();
          },
          [this, loading_new_game_tasks]() {
@@ -592,17 +708,33 @@ void FckGame::newGame()
 
              setState(game_state::LEVEL);
 
-             gui::LevelWidget *level_widget
-                 = static_cast<gui::LevelWidget *>(m_main_widget.getChildren().back());
-             level_widget->setChunks(m_map->getChunks());
-
              m_map->chunk_changed.connect(
                  &system::TargetFollow::onChunkChanged, &m_target_follow_system);
-             m_map->chunk_changed.connect(&gui::LevelWidget::onChunkChanged, level_widget);
-             m_map->chunk_opened.connect(&gui::LevelWidget::onChunkOpened, level_widget);
+
+             if (!isHeadless())
+             {
+                 gui::LevelWidget *level_widget
+                     = static_cast<gui::LevelWidget *>(m_main_widget.getChildren().back());
+                 level_widget->setChunks(m_map->getChunks());
+
+                 m_map->chunk_changed.connect(&gui::LevelWidget::onChunkChanged, level_widget);
+                 m_map->chunk_opened.connect(&gui::LevelWidget::onChunkOpened, level_widget);
+             }
 
              m_map->setCurrentChunk(m_map->getFirstChunkCoords(), {m_player_entity});
 
+             auto settings = Settings::getGlobal();
+             if (!settings->stress_entity_name.empty())
+             {
+                 m_stress_scenario = std::make_unique<StressScenario>(
+                     settings->stress_entities_counts,
+                     settings->stress_ticks,
+                     settings->stress_script_name,
+                     [this, entity_name = settings->stress_entity_name](int32_t count) {
+                         return spawnEnemies(entity_name, count);
+                     });
+             }
+
              loading_new_game_tasks->deleteLater();
          }});
 
@@ -613,8 +745,14 @@ void FckGame::returnToMainMenu()
 {
     TaskSequence *return_to_main_menu_tasks = new TaskSequence();
     return_to_main_menu_tasks->setTasks(
-        {[this]() { setState(game_state::LOADING); },
+        {[this]() {
+             stopInputReplay();
+             setState(game_state::LOADING);
+         },
          [this, return_to_main_menu_tasks]() {
+             if (isHeadless())
+                 return;
+
              gui::LoadingWidget *loading_widget
                  = static_cast<gui::LoadingWidget *>(m_main_widget.getChildren().back());
              loading_widget->setTotal(return_to_main_menu_tasks->getTasks().size() - 2);
@@ -622,6 +760,7 @@ void FckGame::returnToMainMenu()
                  &gui::LoadingWidget::next, loading_widget);
          },
          [this]() {
+             m_stress_scenario.reset();
              m_map.reset();
              map_changed(nullptr);
          },
@@ -637,6 +776,77 @@ void FckGame::returnToMainMenu()
     return_to_main_menu_tasks->start();
 }
 
+std::vector<Entity> FckGame::spawnEnemies(const std::string &entity_name, int32_t count)
+{
+    std::vector<Entity> enemies;
+
+    if (count <= 0)
+        return enemies;
+
+    const map::Chunk *chunk = m_map->getChunks().getData(m_map->getFirstChunkCoords());
+    const Vector2D<int32_t> &walls = chunk->getWalls();
+    sf::Vector2i wall_size = chunk->getWallSize();
+
+    std::vector<sf::Vector2i> free_cells;
+    for (int32_t i = 0; i < int32_t(walls.getSize()); ++i)
+    {
+        if (walls.at(i) == 0)
+            free_cells.push_back(walls.transformIndex(i));
+    }
+
+    if (free_cells.empty())
+        return enemies;
+
+    // Components of all enemies are created pool by pool
+    enemies = EntityFactory::createEntities(entity_name, count, &m_world);
+    if (int32_t(enemies.size()) != count)
+        spdlog::warn(
+            "Can't spawn enemies: {}, spawned {} of {}", entity_name, enemies.size(), count);
+
+    for (Entity &enemy : enemies)
+    {
+        sf::Vector2i cell = free_cells[Random::uniformInt(0, int32_t(free_cells.size() - 1))];
+        entity_funcs::setPosition(
+            enemy, sf::Vector2f{vector2::mult(cell, wall_size) + wall_size / 2});
+        entity_funcs::setState(enemy, entity_state::IDLE);
+        enemy.enable();
+    }
+
+    spdlog::info("Spawned enemies: {} x {}", entity_name, enemies.size());
+    return enemies;
+}
+
+void FckGame::startInputReplay()
+{
+    auto settings = Settings::getGlobal();
+
+    if (!settings->input_replay_file_name.empty()
+        && m_input_replay.loadFromFile(settings->input_replay_file_name))
+    {
+        Random::setSeed(m_input_replay.getSeed());
+        m_input_replay.startPlaying();
+        return;
+    }
+
+    uint32_t seed = settings->random_seed != 0 ? settings->random_seed : std::random_device{}();
+    Random::setSeed(seed);
+
+    if (!settings->input_record_file_name.empty())
+        m_input_replay.startRecording(seed);
+}
+
+void FckGame::stopInputReplay()
+{
+    if (m_input_replay.getMode() == InputReplay<keyboard_action::Action>::RECORDING)
+    {
+        m_input_replay.stop();
+        m_input_replay.saveToFile(Settings::getGlobal()->input_record_file_name);
+        return;
+    }
+
+    m_input_replay.stop();
+}
+
 void FckGame::setupInputActions()
 {
     m_input_actions[keyboard_action::BACK]
@@ -644,6 +854,10 @@ void FckGame::setupInputActions()
 
     m_input_actions[keyboard_action::TOGGLE_RENDER_DEBUG]
         = InputAction(sf::Keyboard::F1, InputAction::RELEASE_ONCE);
+    m_input_actions[keyboard_action::TOGGLE_PROFILER]
+        = InputAction(sf::Keyboard::F2, InputAction::RELEASE_ONCE);
+    m_input_actions[keyboard_action::EXPORT_PROFILER_TRACE]
+        = InputAction(sf::Keyboard::F3, InputAction::RELEASE_ONCE);
 
     m_input_actions[keyboard_action::PLAYER_MOVE_LEFT]
         = InputAction(sf::Keyboard::A, InputAction::HOLD);
@@ -665,11 +879,50 @@ void FckGame::setupInputActions()
         = InputAction(sf::Keyboard::L, InputAction::PRESS_ONCE);
 }
 
+void FckGame::drawProfiler()
+{
+    sf::Font *font = ResourceCache::get<sf::Font>("font");
+    if (!font)
+        return;
+
+    std::string profiler_string = fmt::format("frame: {:.2f} ms\n", Profiler::getFrameTime());
+    for (const Profiler::ZoneStats &zone_stats : Profiler::getFrameStats())
+    {
+        profiler_string += fmt::format(
+            "{}{}: {:.3f} ms, {} calls, max {:.3f} ms\n",
+            std::string(zone_stats.depth * 2, ' '),
+            zone_stats.name,
+            zone_stats.total_time,
+            zone_stats.calls,
+            zone_stats.max_time);
+    }
+
+    sf::Text profiler_text;
+    profiler_text.setFont(*font);
+    profiler_text.setCharacterSize(16);
+    profiler_text.setFillColor(sf::Color::White);
+    profiler_text.setOutlineColor(sf::Color::Black);
+    profiler_text.setOutlineThickness(1);
+    profiler_text.setString(profiler_string);
+    profiler_text.setPosition({8, 8});
+
+    getRrenderWindow().draw(profiler_text);
+}
+
 void FckGame::onActionActivated(keyboard_action::Action action)
 {
     if (action == keyboard_action::TOGGLE_RENDER_DEBUG)
         m_render_debug = !m_render_debug;
 
+    if (action == keyboard_action::TOGGLE_PROFILER)
+    {
+        m_render_profiler = !m_render_profiler;
+        Profiler::setEnabled(m_render_profiler);
+    }
+
+    if (action == keyboard_action::EXPORT_PROFILER_TRACE)
+        Profiler::exportChromeTrace("profiler_trace.json");
+
     if (action == keyboard_action::BACK)
         EventDispatcher::runTask([this]() { setState(game_state::LEVEL_MENU); });
 }
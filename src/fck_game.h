@@ -5,10 +5,15 @@
 #include "fck/base_game.h"
 #include "fck/event_handler.h"
 #include "fck/input_actions_map.h"
+#include "fck/input_replay.h"
+#include "fck/perf_counters.h"
+#include "fck/profiler.h"
+#include "fck/system_scheduler.h"
 #include "fck/world.h"
 #include "fck_common.h"
 #include "gui/gui.h"
 #include "map/map.h"
+#include "stress_scenario.h"
 #include "systems/systems.h"
 
 #include <SFML/Graphics.hpp>
@@ -25,10 +30,12 @@ class FckGame : public BaseGame
 {
 public:
     FckGame();
-    ~FckGame() = default;
+    ~FckGame();
 
     void init();
 
+    game_state::State getState() const;
+
 protected:
     void event(const sf::Event &e);
     void update(const sf::Time &elapsed);
@@ -39,6 +46,7 @@ private:
 
     void event(Event *event);
 
+    void initHeadless();
     void initFirstResources();
     void loadFonts();
     void loadTextures();
@@ -48,8 +56,15 @@ private:
     void newGame();
     void returnToMainMenu();
 
+    std::vector<Entity> spawnEnemies(const std::string &entity_name, int32_t count);
+
+    void startInputReplay();
+    void stopInputReplay();
+
     void setupInputActions();
 
+    void drawProfiler();
+
 public: // slots
     void onActionActivated(keyboard_action::Action action);
 
@@ -68,6 +83,7 @@ private:
     gui::MainWidget m_main_widget;
 
     InputActionsMap<keyboard_action::Action> m_input_actions;
+    InputReplay<keyboard_action::Action> m_input_replay;
 
     sf::View m_scene_view;
     std::list<Entity> m_visible_entities;
@@ -80,6 +96,8 @@ private:
     std::unique_ptr<map::Map> m_map;
     Entity m_player_entity;
 
+    std::unique_ptr<StressScenario> m_stress_scenario;
+
     system::Render m_render_system;
     system::Player m_player_system;
     system::Movement m_movement_system;
@@ -94,8 +112,12 @@ private:
     system::Skills m_skills_system;
     system::Damage m_damage_sysytem;
     system::Sound m_sound_system;
+    system::TransformHierarchy m_transform_hierarchy_system;
+
+    SystemScheduler m_system_scheduler;
 
     bool m_render_debug;
+    bool m_render_profiler;
 
     sol::state m_lua_state;
 };
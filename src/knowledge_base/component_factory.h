@@ -17,10 +17,15 @@ namespace fck
 class ComponentFactory
 {
 public:
+    // Component prefab: table is parsed once in init(), create() only copies parsed values
     struct Factory
     {
+        virtual ~Factory() = default;
+
+        virtual void init([[maybe_unused]] toml::table &component_table)
+        {
+        }
         virtual void create(Entity &entity) = 0;
-        toml::table component_table;
     };
 
     template<typename T>
@@ -10,17 +10,20 @@ namespace fck
 EntityFactory::Factory::Factory(Factory &&other)
 {
     m_components = std::move(other.m_components);
+    m_component_types = std::move(other.m_component_types);
 }
 
 EntityFactory::Factory &EntityFactory::Factory::operator=(Factory &&other)
 {
     m_components = std::move(other.m_components);
+    m_component_types = std::move(other.m_component_types);
     return *this;
 }
 
 bool EntityFactory::Factory::init(toml::table &table)
 {
     m_components.clear();
+    m_component_types.clear();
 
     try
     {
@@ -43,8 +46,9 @@ bool EntityFactory::Factory::init(toml::table &table)
                 throw Exception(
                     fmt::format("Can't create component factory for type: ", it.first.data()));
 
-            component_factory->component_table = *component_table;
             m_components.push_back(std::unique_ptr<ComponentFactory::Factory>(component_factory));
+            m_component_types.push_back(component_type);
+            component_factory->init(*component_table);
         }
     }
     catch (const std::exception &e)
@@ -75,9 +79,57 @@ Entity EntityFactory::Factory::createEntity(World *world)
     return entity;
 }
 
+std::vector<Entity> EntityFactory::Factory::createEntities(World *world, int32_t count)
+{
+    std::vector<Entity> entities = world->createEntities(count);
+
+    // Component by component, so each pool is filled in one pass
+    for (const auto &it : m_components)
+    {
+        for (Entity &entity : entities)
+        {
+            if (!entity.isValid())
+                continue;
+
+            try
+            {
+                it->create(entity);
+            }
+            catch (const std::exception &e)
+            {
+                spdlog::warn(e.what());
+                entity.destroy();
+                entity = Entity{};
+            }
+        }
+    }
+
+    std::erase_if(entities, [](const Entity &entity) { return !entity.isValid(); });
+    return entities;
+}
+
+ComponentFactory::Factory *EntityFactory::Factory::findComponent(
+    component_type::Type component_type) const
+{
+    for (std::size_t i = 0; i < m_component_types.size(); ++i)
+    {
+        if (m_component_types[i] == component_type)
+            return m_components[i].get();
+    }
+
+    return nullptr;
+}
+
 void EntityFactory::registerEntityFactory(const std::string &entity_name, Factory &&entity_factory)
 {
     spdlog::info("Register entity factory: {}", entity_name);
+
+    // Restored drawable finds its prefab by name
+    auto drawable_factory = static_cast<DrawableComponentFactory *>(
+        entity_factory.findComponent(component_type::DRAWABLE));
+    if (drawable_factory)
+        drawable_factory->prefab_name = entity_name;
+
     instance().m_entity_factories[entity_name]
         = std::make_unique<Factory>(std::move(entity_factory));
 }
@@ -114,6 +166,19 @@ Entity EntityFactory::createEntity(const std::string &entity_name, World *world)
     return entities_found->second->createEntity(world);
 }
 
+std::vector<Entity> EntityFactory::createEntities(
+    const std::string &entity_name, int32_t count, World *world)
+{
+    if (!world || count <= 0)
+        return {};
+
+    auto entities_found = instance().m_entity_factories.find(entity_name);
+    if (entities_found == instance().m_entity_factories.end())
+        return {};
+
+    return entities_found->second->createEntities(world, count);
+}
+
 Entity EntityFactory::createPlayer(const std::string &entity_name, World *world)
 {
     Entity entity = createEntity(entity_name, world);
@@ -124,6 +189,16 @@ Entity EntityFactory::createPlayer(const std::string &entity_name, World *world)
     return entity;
 }
 
+const ComponentFactory::Factory *EntityFactory::findComponentFactory(
+    const std::string &entity_name, component_type::Type component_type)
+{
+    auto entities_found = instance().m_entity_factories.find(entity_name);
+    if (entities_found == instance().m_entity_factories.end())
+        return nullptr;
+
+    return entities_found->second->findComponent(component_type);
+}
+
 EntityFactory &EntityFactory::instance()
 {
     static EntityFactory entities_factory;
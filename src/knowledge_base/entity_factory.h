@@ -24,9 +24,13 @@ public:
 
         bool init(toml::table &table);
         Entity createEntity(World *world);
+        std::vector<Entity> createEntities(World *world, int32_t count);
+
+        ComponentFactory::Factory *findComponent(component_type::Type component_type) const;
 
     private:
         std::vector<std::unique_ptr<ComponentFactory::Factory>> m_components;
+        std::vector<component_type::Type> m_component_types;
     };
 
     static void registerEntityFactory(const std::string &entity_name, Factory &&entity_factory);
@@ -34,8 +38,14 @@ public:
     static void registerEntityFactory(const std::string &entity_name, const std::string &table_str);
 
     static Entity createEntity(const std::string &entity_name, World *world);
+    static std::vector<Entity> createEntities(
+        const std::string &entity_name, int32_t count, World *world);
     static Entity createPlayer(const std::string &entity_name, World *world);
 
+    // Component prefab of entity, used to rebuild components which aren't serialized as is
+    static const ComponentFactory::Factory *findComponentFactory(
+        const std::string &entity_name, component_type::Type component_type);
+
 private:
     static EntityFactory &instance();
 
@@ -24,6 +24,12 @@ void ScriptFactory::setSolState(sol::state *sol_state)
     instance().m_sol_state = sol_state;
 }
 
+void ScriptFactory::clear()
+{
+    instance().m_script_factories.clear();
+    instance().m_sol_state = nullptr;
+}
+
 void ScriptFactory::registerScriptFactory(
     const std::string &script_name, const std::string &script_str)
 {
@@ -18,6 +18,8 @@ public:
     };
 
     static void setSolState(sol::state *sol_state);
+    // Drops factories and lua state, functions of factories belong to the state
+    static void clear();
     static void registerScriptFactory(
         const std::string &script_name, const std::string &script_str);
     static script::Script *createScript(const std::string &script_name);
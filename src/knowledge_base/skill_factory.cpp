@@ -6,6 +6,11 @@
 namespace fck
 {
 
+const std::string &SkillFactory::Factory::getSkillName() const
+{
+    return m_skill_name;
+}
+
 std::string SkillFactory::Factory::getSkillDisplayName() const
 {
     return m_skill_table["display_name"];
@@ -44,6 +49,12 @@ void SkillFactory::setSolState(sol::state *sol_state)
     instance().m_sol_state = sol_state;
 }
 
+void SkillFactory::clear()
+{
+    instance().m_skill_factories.clear();
+    instance().m_sol_state = nullptr;
+}
+
 void SkillFactory::registerSkillFactory(const std::string &skill_name, const std::string &skill_str)
 {
     if (!instance().m_sol_state)
@@ -68,6 +79,7 @@ void SkillFactory::registerSkillFactory(const std::string &skill_name, const std
 
     std::unique_ptr<Factory> script_factory = std::make_unique<Factory>();
 
+    script_factory->m_skill_name = skill_name;
     script_factory->m_skill_table = script_result;
     instance().m_skill_factories[skill_name] = std::move(script_factory);
 
@@ -21,6 +21,7 @@ public:
         friend class SkillFactory;
 
     public:
+        const std::string &getSkillName() const;
         std::string getSkillDisplayName() const;
         std::string getSkillDisplayDescription() const;
         std::string getSkillTextureName() const;
@@ -29,10 +30,13 @@ public:
         skill::Skill *createSkill();
 
     private:
+        std::string m_skill_name;
         sol::table m_skill_table;
     };
 
     static void setSolState(sol::state *sol_state);
+    // Drops factories and lua state, tables of factories belong to the state
+    static void clear();
     static void registerSkillFactory(const std::string &skill_name, const std::string &skill_str);
     static skill::Skill *createSkill(const std::string &skill_name);
     static const Factory *getSkillFactory(const std::string &skill_name);
@@ -1,19 +1,70 @@
+#include "fck/perf_counters.h"
 #include "fck_game.h"
 #include "settings.h"
 
 #include <spdlog/spdlog.h>
 
-int main()
+#include <sstream>
+#include <string>
+
+int main(int argc, char *argv[])
 {
     spdlog::set_level(spdlog::level::debug);
     spdlog::info("Welcome to fck_game!");
 
     auto settings = std::make_shared<fck::Settings>();
     settings->loadFromFile("settings.toml");
+
+    // [--headless] [--ticks N] [--real-time] [--seed N] [--record FILE | --replay FILE]
+    // [--perf-counters FILE] [--enemies N]
+    // [--stress NAME [--stress-script NAME] [--stress-counts N,N,...] [--stress-ticks N]]
+    for (int32_t i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "--headless")
+            settings->headless = true;
+        else if (arg == "--ticks" && i + 1 < argc)
+            settings->headless_ticks = std::stoull(argv[++i]);
+        else if (arg == "--real-time")
+            settings->headless_real_time = true;
+        else if (arg == "--seed" && i + 1 < argc)
+            settings->random_seed = std::stoul(argv[++i]);
+        else if (arg == "--record" && i + 1 < argc)
+            settings->input_record_file_name = argv[++i];
+        else if (arg == "--replay" && i + 1 < argc)
+            settings->input_replay_file_name = argv[++i];
+        else if (arg == "--perf-counters" && i + 1 < argc)
+            settings->perf_counters_file_name = argv[++i];
+        else if (arg == "--enemies" && i + 1 < argc)
+            settings->level_enemies_count = std::stoul(argv[++i]);
+        else if (arg == "--stress" && i + 1 < argc)
+            settings->stress_entity_name = argv[++i];
+        else if (arg == "--stress-script" && i + 1 < argc)
+            settings->stress_script_name = argv[++i];
+        else if (arg == "--stress-counts" && i + 1 < argc)
+        {
+            settings->stress_entities_counts.clear();
+            std::stringstream counts_stream{argv[++i]};
+            std::string count;
+            while (std::getline(counts_stream, count, ','))
+                settings->stress_entities_counts.push_back(std::stoul(count));
+        }
+        else if (arg == "--stress-ticks" && i + 1 < argc)
+            settings->stress_ticks = std::stoul(argv[++i]);
+        else
+            spdlog::warn("Unknown argument: {}", arg);
+    }
+
     fck::Settings::setGlobal(settings);
 
     fck::FckGame game;
     game.init();
 
-    return game.exec();
+    int32_t result = game.exec();
+
+    if (!settings->perf_counters_file_name.empty())
+        fck::PerfCounters::dumpCsv(settings->perf_counters_file_name);
+
+    return result;
 }
@@ -1,14 +1,15 @@
 #include "factory.h"
 #include "../components/components.h"
 #include "../fck/noise.h"
+#include "../fck/random.h"
 #include "../fck/tile_map.h"
 #include "../fck/utilities.h"
 #include "../fck_common.h"
 
 #include <spdlog/spdlog.h>
 
+#include <limits>
 #include <queue>
-#include <random>
 
 namespace fck::map
 {
@@ -45,9 +46,8 @@ Map *Factory::createMap(int32_t chunks_count, const std::string &file_name)
             chunk_coords.push_back(map->m_chunks.transformIndex(i));
     }
 
-    std::mt19937 rng{std::random_device{}()};
-    std::uniform_int_distribution<int32_t> seed_dist{0, int32_t(chunk_coords.size() - 1)};
-    map->m_first_chunk_coords = chunk_coords[seed_dist(rng)];
+    map->m_first_chunk_coords
+        = chunk_coords[Random::uniformInt(0, int32_t(chunk_coords.size() - 1))];
 
     return map.release();
 }
@@ -56,15 +56,11 @@ void Factory::createRandomChunks(int32_t chunks_count, Map *map)
 {
     sf::Vector2i noise_map_size = {100, 100};
 
-    std::random_device dev;
-    std::mt19937 rng(dev());
-    std::uniform_int_distribution<int32_t> seed_dist;
-
     noise::RigedMulti riged_multi;
     riged_multi.setFrequency(5);
     riged_multi.setOctaveCount(1);
     riged_multi.setLacunarity(2);
-    riged_multi.setSeed(seed_dist(rng));
+    riged_multi.setSeed(Random::uniformInt(0, std::numeric_limits<int32_t>::max()));
 
     noise::Map noise_map;
     noise::MapGenerator map_generator;
@@ -99,12 +95,9 @@ void Factory::createRandomChunks(int32_t chunks_count, Map *map)
         [&]() {
             sf::Vector2i search_size = noise_map_size / 10;
 
-            std::uniform_int_distribution<int32_t> first_x_coord_dist(
-                search_size.x, noise_map_size.x - search_size.x * 2);
-            std::uniform_int_distribution<int32_t> first_y_coord_dist(
-                search_size.y, noise_map_size.y - search_size.y * 2);
-
-            first_coord = {first_x_coord_dist(rng), first_y_coord_dist(rng)};
+            first_coord
+                = {Random::uniformInt(search_size.x, noise_map_size.x - search_size.x * 2),
+                   Random::uniformInt(search_size.y, noise_map_size.y - search_size.y * 2)};
 
             for (int32_t i = 0; i < (search_size.x * search_size.y); ++i)
             {
@@ -221,13 +214,17 @@ void Factory::createChunksContent(Map *map, const Tmx &tmx)
 
 void Factory::createChunk(Map *map, Chunk *chunk, const Tmx::Group &chunks_group, const Tmx &tmx)
 {
-    std::random_device dev;
-    std::mt19937 rng(dev());
-    std::uniform_int_distribution<int32_t> dist(0, chunks_group.groups.size() - 1);
+    const Tmx::Group &chunk_group
+        = chunks_group.groups[Random::uniformInt(0, int32_t(chunks_group.groups.size() - 1))];
+
+    int32_t entities_count = chunk_group.layers.size();
+    for (const Tmx::ObjectGroup &object_group : chunk_group.object_groups)
+        entities_count += object_group.objects.size();
 
-    const Tmx::Group &chunk_group = chunks_group.groups[dist(rng)];
+    m_world->reserve(m_world->getEntityCount() + entities_count);
 
     std::vector<Entity> entities;
+    entities.reserve(entities_count);
     std::unordered_map<chunk_side::Side, Entity> chunk_entry_entities;
 
     createChunkTilemaps(chunk, entities, chunk_group.layers, tmx);
@@ -378,6 +375,7 @@ std::pair<Entity, const Tmx::Tileset *> Factory::createTilemapEntity(
     }
 
     drawable_component.proxy.reset(new DrawableProxy(tile_map));
+    drawable_component.tile_map_texture_name = tileset->name;
     drawable_component.z_order_fill_y_coordinate = false;
 
     return {entity, tileset};
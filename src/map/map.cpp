@@ -5,7 +5,10 @@
 namespace fck::map
 {
 Map::Map(b2::DynamicTree<Entity> *scene_tree)
-    : m_scene_tree{scene_tree}, m_first_chunk_coords{-1, -1}, m_current_chunk_coords{-1, -1}
+    : m_scene_tree{scene_tree},
+      m_first_chunk_coords{-1, -1},
+      m_current_chunk_coords{-1, -1},
+      m_path_planner_built{false}
 {
 }
 
@@ -108,4 +111,15 @@ sf::Vector2i Map::tileCoordsByPosition(const sf::Vector2f &position)
     return {int32_t(position.x) / m_tile_size.x, int32_t(position.y) / m_tile_size.y};
 }
 
+PathPlanner &Map::getPathPlanner()
+{
+    if (!m_path_planner_built)
+    {
+        m_path_planner.build(this);
+        m_path_planner_built = true;
+    }
+
+    return m_path_planner;
+}
+
 } // namespace fck::map
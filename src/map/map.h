@@ -2,6 +2,7 @@
 #define MAP_DWSXIQQZKECD_H
 
 #include "chunk.h"
+#include "path_planner.h"
 
 #include "../fck/b2_dynamic_tree.h"
 #include "../fck/vector_2d.h"
@@ -34,6 +35,9 @@ public:
 
     sf::Vector2i tileCoordsByPosition(const sf::Vector2f &position);
 
+    // Built on first use, map creation doesn't pay for graph of chunks
+    PathPlanner &getPathPlanner();
+
 public:
     sigslot::signal<const sf::Vector2i &> chunk_opened;
     sigslot::signal<const sf::Vector2i &> chunk_changed;
@@ -48,6 +52,9 @@ private:
 
     sf::Vector2i m_first_chunk_coords;
     sf::Vector2i m_current_chunk_coords;
+
+    PathPlanner m_path_planner;
+    bool m_path_planner_built;
 };
 
 } // namespace fck::map
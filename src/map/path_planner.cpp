@@ -0,0 +1,340 @@
+#include "path_planner.h"
+#include "map.h"
+
+#include "../components/components.h"
+#include "../fck/profiler.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+
+namespace fck::map
+{
+
+PathPlanner::PathPlanner() : m_map{nullptr}
+{
+    m_path_finder.setHeuristic(PathFinder::Heuristic::OCTAGONAL);
+}
+
+void PathPlanner::build(const Map *map)
+{
+    FCK_PROFILE_ZONE("PathPlanner::build");
+
+    clear();
+    m_map = map;
+
+    const Vector2D<Chunk *> &chunks = m_map->getChunks();
+    m_chunk_portals.resize(chunks.getSize2D());
+
+    // Portals are entries which lead to entry of neighbor chunk
+    for (int32_t i = 0; i < int32_t(chunks.getSize()); ++i)
+    {
+        const Chunk *chunk = chunks.at(i);
+        if (!chunk)
+            continue;
+
+        sf::Vector2i chunk_coords = chunks.transformIndex(i);
+
+        for (const auto &[side, entry_entity] : chunk->getChunkEntryEntities())
+        {
+            if (!(chunk->getNeighbors() & side))
+                continue;
+
+            const Chunk *neighbor_chunk = getChunk(chunk_coords + sideOffset(side));
+            if (!neighbor_chunk
+                || neighbor_chunk->getChunkEntryEntities().count(oppositeSide(side)) == 0)
+                continue;
+
+            sf::Vector2i coords;
+            if (!findPortalCoords(chunk, entry_entity, coords))
+                continue;
+
+            m_chunk_portals[i].push_back(int32_t(m_portals.size()));
+            m_portals.push_back({chunk_coords, side, coords, {}});
+        }
+    }
+
+    for (int32_t i = 0; i < int32_t(m_chunk_portals.getSize()); ++i)
+    {
+        const std::vector<int32_t> &chunk_portals = m_chunk_portals.at(i);
+
+        for (int32_t portal_index : chunk_portals)
+        {
+            Portal &portal = m_portals[portal_index];
+
+            // Transition to entry of neighbor chunk
+            sf::Vector2i neighbor_chunk_coords = portal.chunk_coords + sideOffset(portal.side);
+            for (int32_t neighbor_portal_index : m_chunk_portals.getData(neighbor_chunk_coords))
+            {
+                if (m_portals[neighbor_portal_index].side == oppositeSide(portal.side))
+                    portal.edges.push_back({neighbor_portal_index, TRANSITION_COST});
+            }
+
+            // Paths to other entries of same chunk
+            for (int32_t other_portal_index : chunk_portals)
+            {
+                if (other_portal_index == portal_index)
+                    continue;
+
+                uint32_t cost = findCost(
+                    portal.chunk_coords, portal.coords, m_portals[other_portal_index].coords);
+                if (cost != NO_COST)
+                    portal.edges.push_back({other_portal_index, cost});
+            }
+        }
+    }
+
+    spdlog::info("Path planner built: {} portals", m_portals.size());
+}
+
+void PathPlanner::clear()
+{
+    m_map = nullptr;
+    m_portals.clear();
+    m_chunk_portals.clear();
+}
+
+int32_t PathPlanner::getPortalsCount() const
+{
+    return int32_t(m_portals.size());
+}
+
+std::vector<PathPlanner::Waypoint> PathPlanner::findPath(
+    const Waypoint &source, const Waypoint &target)
+{
+    FCK_PROFILE_ZONE("PathPlanner::findPath");
+
+    if (!getChunk(source.chunk_coords) || !getChunk(target.chunk_coords))
+        return {};
+
+    // Source and target are temporary nodes of abstract graph
+    const int32_t source_node = int32_t(m_portals.size());
+    const int32_t target_node = source_node + 1;
+
+    std::vector<uint32_t> costs(m_portals.size() + 2, NO_COST);
+    std::vector<int32_t> parents(m_portals.size() + 2, -1);
+
+    // Costs from portals of target chunk to target
+    std::vector<std::pair<int32_t, uint32_t>> target_edges;
+    for (int32_t portal_index : m_chunk_portals.getData(target.chunk_coords))
+    {
+        uint32_t cost
+            = findCost(target.chunk_coords, m_portals[portal_index].coords, target.coords);
+        if (cost != NO_COST)
+            target_edges.push_back({portal_index, cost});
+    }
+
+    using QueueItem = std::pair<uint32_t, int32_t>;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> opened;
+
+    auto relax = [&](int32_t from, int32_t to, uint32_t edge_cost) {
+        uint32_t cost = costs[from] + edge_cost;
+        if (cost < costs[to])
+        {
+            costs[to] = cost;
+            parents[to] = from;
+            opened.push({cost, to});
+        }
+    };
+
+    costs[source_node] = 0;
+    opened.push({0, source_node});
+
+    // Abstract graph is small, so Dijkstra is enough
+    while (!opened.empty())
+    {
+        auto [cost, node] = opened.top();
+        opened.pop();
+
+        if (cost != costs[node])
+            continue;
+
+        if (node == target_node)
+            break;
+
+        if (node == source_node)
+        {
+            if (source.chunk_coords == target.chunk_coords)
+            {
+                uint32_t direct_cost
+                    = findCost(source.chunk_coords, source.coords, target.coords);
+                if (direct_cost != NO_COST)
+                    relax(source_node, target_node, direct_cost);
+            }
+
+            for (int32_t portal_index : m_chunk_portals.getData(source.chunk_coords))
+            {
+                uint32_t portal_cost = findCost(
+                    source.chunk_coords, source.coords, m_portals[portal_index].coords);
+                if (portal_cost != NO_COST)
+                    relax(source_node, portal_index, portal_cost);
+            }
+            continue;
+        }
+
+        for (const auto &[portal_index, edge_cost] : m_portals[node].edges)
+            relax(node, portal_index, edge_cost);
+
+        if (m_portals[node].chunk_coords == target.chunk_coords)
+        {
+            for (const auto &[portal_index, edge_cost] : target_edges)
+            {
+                if (portal_index == node)
+                    relax(node, target_node, edge_cost);
+            }
+        }
+    }
+
+    std::vector<Waypoint> path;
+    if (costs[target_node] == NO_COST)
+        return path;
+
+    for (int32_t node = target_node; node != -1; node = parents[node])
+    {
+        if (node == target_node)
+            path.push_back(target);
+        else if (node == source_node)
+            path.push_back(source);
+        else
+            path.push_back({m_portals[node].chunk_coords, m_portals[node].coords});
+    }
+
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+std::vector<sf::Vector2i> PathPlanner::refinePath(
+    const std::vector<Waypoint> &path, const Waypoint &source)
+{
+    const Chunk *chunk = getChunk(source.chunk_coords);
+    if (!chunk)
+        return {};
+
+    auto waypoint_found
+        = std::find_if(path.begin(), path.end(), [&source](const Waypoint &waypoint) {
+              return waypoint.chunk_coords == source.chunk_coords;
+          });
+
+    if (waypoint_found == path.end())
+        return {};
+
+    // Last waypoint before path leaves chunk
+    while (waypoint_found + 1 != path.end()
+           && (waypoint_found + 1)->chunk_coords == source.chunk_coords)
+        ++waypoint_found;
+
+    m_path_finder.setWalls(chunk->getWalls());
+    return m_path_finder.findPath(source.coords, waypoint_found->coords);
+}
+
+bool PathPlanner::findPortalCoords(
+    const Chunk *chunk, const Entity &entry_entity, sf::Vector2i &coords)
+{
+    if (!entry_entity.isValid() || !entry_entity.has<component::Scene>())
+        return false;
+
+    const Vector2D<int32_t> &walls = chunk->getWalls();
+    const sf::Vector2i &wall_size = chunk->getWallSize();
+    if (wall_size.x == 0 || wall_size.y == 0)
+        return false;
+
+    const sf::FloatRect &bounds = entry_entity.get<component::Scene>().global_bounds;
+
+    sf::Vector2i lower = {int32_t(bounds.left) / wall_size.x, int32_t(bounds.top) / wall_size.y};
+    sf::Vector2i upper
+        = {int32_t(bounds.left + bounds.width) / wall_size.x,
+           int32_t(bounds.top + bounds.height) / wall_size.y};
+
+    lower = {std::max(lower.x, 0), std::max(lower.y, 0)};
+    upper
+        = {std::min(upper.x, walls.getSize2D().x - 1), std::min(upper.y, walls.getSize2D().y - 1)};
+
+    // Free cell of entry nearest to its center
+    sf::Vector2i center = (lower + upper) / 2;
+    int32_t min_distance = -1;
+
+    for (int32_t y = lower.y; y <= upper.y; ++y)
+    {
+        for (int32_t x = lower.x; x <= upper.x; ++x)
+        {
+            if (walls.getData({x, y}) > 0)
+                continue;
+
+            int32_t distance = std::abs(x - center.x) + std::abs(y - center.y);
+            if (min_distance < 0 || distance < min_distance)
+            {
+                min_distance = distance;
+                coords = {x, y};
+            }
+        }
+    }
+
+    return min_distance >= 0;
+}
+
+const Chunk *PathPlanner::getChunk(const sf::Vector2i &chunk_coords) const
+{
+    if (!m_map)
+        return nullptr;
+
+    const Vector2D<Chunk *> &chunks = m_map->getChunks();
+    if (chunk_coords.x < 0 || chunk_coords.y < 0 || chunk_coords.x >= chunks.getSize2D().x
+        || chunk_coords.y >= chunks.getSize2D().y)
+        return nullptr;
+
+    return chunks.getData(chunk_coords);
+}
+
+uint32_t PathPlanner::findCost(
+    const sf::Vector2i &chunk_coords, const sf::Vector2i &source, const sf::Vector2i &target)
+{
+    m_path_finder.setWalls(getChunk(chunk_coords)->getWalls());
+    std::vector<sf::Vector2i> path = m_path_finder.findPath(source, target);
+    if (path.empty())
+        return NO_COST;
+
+    uint32_t cost = 0;
+    for (std::size_t i = 1; i < path.size(); ++i)
+        cost += (path[i].x != path[i - 1].x && path[i].y != path[i - 1].y) ? 14 : 10;
+
+    return cost;
+}
+
+sf::Vector2i PathPlanner::sideOffset(chunk_side::Side side)
+{
+    switch (side)
+    {
+    case chunk_side::LEFT:
+        return {-1, 0};
+    case chunk_side::TOP:
+        return {0, -1};
+    case chunk_side::RIGHT:
+        return {1, 0};
+    case chunk_side::BOTTOM:
+        return {0, 1};
+    default:
+        return {0, 0};
+    }
+}
+
+chunk_side::Side PathPlanner::oppositeSide(chunk_side::Side side)
+{
+    switch (side)
+    {
+    case chunk_side::LEFT:
+        return chunk_side::RIGHT;
+    case chunk_side::TOP:
+        return chunk_side::BOTTOM;
+    case chunk_side::RIGHT:
+        return chunk_side::LEFT;
+    case chunk_side::BOTTOM:
+        return chunk_side::TOP;
+    default:
+        return chunk_side::NO_SIDE;
+    }
+}
+
+} // namespace fck::map
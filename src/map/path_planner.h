@@ -0,0 +1,82 @@
+#ifndef PATHPLANNER_HVNQXCEOBZRS_H
+#define PATHPLANNER_HVNQXCEOBZRS_H
+
+#include "chunk.h"
+
+#include "../fck/a_star.h"
+#include "../fck/vector_2d.h"
+
+#include <SFML/System/Vector2.hpp>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace fck::map
+{
+
+class Map;
+
+// Hierarchical (HPA*) planner over chunks of map. Nodes of abstract graph are chunk entries
+// (portals) connected inside chunk by cost of precomputed cell path and with entry of neighbor
+// chunk by transition cost. Cell path is refined only for chunk which is traversed.
+class PathPlanner
+{
+public:
+    struct Waypoint
+    {
+        sf::Vector2i chunk_coords;
+        // Wall cell in chunk
+        sf::Vector2i coords;
+    };
+
+    PathPlanner();
+    ~PathPlanner() = default;
+
+    void build(const Map *map);
+    void clear();
+
+    int32_t getPortalsCount() const;
+
+    // Source, entries of traversed chunks and target. Empty if target isn't reachable
+    std::vector<Waypoint> findPath(const Waypoint &source, const Waypoint &target);
+
+    // Cell path from source to waypoint where path leaves source chunk, same format as
+    // PathFinder::findPath
+    std::vector<sf::Vector2i> refinePath(
+        const std::vector<Waypoint> &path, const Waypoint &source);
+
+private:
+    struct Portal
+    {
+        sf::Vector2i chunk_coords;
+        chunk_side::Side side;
+        sf::Vector2i coords;
+        // Portal index and cost
+        std::vector<std::pair<int32_t, uint32_t>> edges;
+    };
+
+    static constexpr uint32_t TRANSITION_COST = 10;
+    static constexpr uint32_t NO_COST = UINT32_MAX;
+
+    bool findPortalCoords(const Chunk *chunk, const Entity &entry_entity, sf::Vector2i &coords);
+    const Chunk *getChunk(const sf::Vector2i &chunk_coords) const;
+
+    uint32_t findCost(
+        const sf::Vector2i &chunk_coords, const sf::Vector2i &source, const sf::Vector2i &target);
+
+    static sf::Vector2i sideOffset(chunk_side::Side side);
+    static chunk_side::Side oppositeSide(chunk_side::Side side);
+
+private:
+    const Map *m_map;
+    std::vector<Portal> m_portals;
+    // Portal indexes of every chunk
+    Vector2D<std::vector<int32_t>> m_chunk_portals;
+
+    PathFinder m_path_finder;
+};
+
+} // namespace fck::map
+
+#endif // PATHPLANNER_HVNQXCEOBZRS_H
@@ -1,5 +1,8 @@
 #include "script.h"
 
+#include "../fck/perf_counters.h"
+#include "../fck/profiler.h"
+
 #include <spdlog/spdlog.h>
 
 namespace fck::script
@@ -33,8 +36,11 @@ void Script::setEntityToTable(const Entity &entity)
 
 void Script::update(double delta_time)
 {
+    FCK_PROFILE_ZONE("Script::update");
+
     if (m_update_function)
     {
+        FCK_PERF_COUNTER_ADD("Lua calls", 1);
         auto result = m_update_function(m_script_table, delta_time);
         if (!result.valid())
         {
@@ -46,8 +52,11 @@ void Script::update(double delta_time)
 
 void Script::onEntityEnabled()
 {
+    FCK_PROFILE_ZONE("Script::onEntityEnabled");
+
     if (m_entity_enabled_function)
     {
+        FCK_PERF_COUNTER_ADD("Lua calls", 1);
         auto result = m_entity_enabled_function(m_script_table);
         if (!result.valid())
         {
@@ -59,8 +68,11 @@ void Script::onEntityEnabled()
 
 void Script::onEntityDisabled()
 {
+    FCK_PROFILE_ZONE("Script::onEntityDisabled");
+
     if (m_entity_disabled_function)
     {
+        FCK_PERF_COUNTER_ADD("Lua calls", 1);
         auto result = m_entity_disabled_function(m_script_table);
         if (!result.valid())
         {
@@ -72,8 +84,11 @@ void Script::onEntityDisabled()
 
 void Script::onEntityDestroyed()
 {
+    FCK_PROFILE_ZONE("Script::onEntityDestroyed");
+
     if (m_entity_destroyed_function)
     {
+        FCK_PERF_COUNTER_ADD("Lua calls", 1);
         auto result = m_entity_destroyed_function(m_script_table);
         if (!result.valid())
         {
@@ -85,8 +100,11 @@ void Script::onEntityDestroyed()
 
 void Script::onEntityMoved(const sf::Vector2f &offset)
 {
+    FCK_PROFILE_ZONE("Script::onEntityMoved");
+
     if (m_entity_moved_function)
     {
+        FCK_PERF_COUNTER_ADD("Lua calls", 1);
         auto result = m_entity_moved_function(m_script_table, offset);
         if (!result.valid())
         {
@@ -98,8 +116,11 @@ void Script::onEntityMoved(const sf::Vector2f &offset)
 
 void Script::onEntityStateChanged(entity_state::State state)
 {
+    FCK_PROFILE_ZONE("Script::onEntityStateChanged");
+
     if (m_entity_state_changed_function)
     {
+        FCK_PERF_COUNTER_ADD("Lua calls", 1);
         auto result = m_entity_state_changed_function(m_script_table, state);
         if (!result.valid())
         {
@@ -111,8 +132,11 @@ void Script::onEntityStateChanged(entity_state::State state)
 
 void Script::onEntityDirectionChanged(entity_state::Direction direction)
 {
+    FCK_PROFILE_ZONE("Script::onEntityDirectionChanged");
+
     if (m_entity_direction_changed_function)
     {
+        FCK_PERF_COUNTER_ADD("Lua calls", 1);
         auto result = m_entity_direction_changed_function(m_script_table, direction);
         if (!result.valid())
         {
@@ -124,8 +148,11 @@ void Script::onEntityDirectionChanged(entity_state::Direction direction)
 
 void Script::onEntityCollided(const Entity &other)
 {
+    FCK_PROFILE_ZONE("Script::onEntityCollided");
+
     if (m_entity_collided_function)
     {
+        FCK_PERF_COUNTER_ADD("Lua calls", 1);
         auto result = m_entity_collided_function(m_script_table, other);
         if (!result.valid())
         {
@@ -9,6 +9,23 @@ Settings::Settings()
     window_height = 768;
     fullscreen = false;
 
+    headless = false;
+    headless_ticks = 0;
+    headless_real_time = false;
+
+    level_enemy_name = "kyoshi_2";
+    level_enemies_count = 0;
+
+    stress_entities_counts = {100, 1000, 10000, 50000};
+    stress_ticks = 300;
+    stress_report_file_name = "stress_report.csv";
+
+    random_seed = 0;
+
+#ifdef FCK_COUNT_ALLOCATIONS
+    perf_counters_file_name = "perf_counters.csv";
+#endif
+
     level_keyboard_actions_file_name = "l_ka.toml";
     main_menu_keyboard_actions_file_name = "mm_ka.toml";
     splash_screen_bg_file_name = "resources/textures/splash.png";
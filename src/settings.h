@@ -3,6 +3,8 @@
 
 #include "fck/base_settings.h"
 
+#include <vector>
+
 namespace fck
 {
 
@@ -19,6 +21,34 @@ public:
     uint32_t window_height;
     bool fullscreen;
 
+    // Simulation without window, rendering and audio
+    bool headless;
+    // Ticks to run in headless mode, 0 runs until exit
+    uint64_t headless_ticks;
+    // Headless ticks wait for wall clock instead of running at max speed
+    bool headless_real_time;
+
+    // Extra enemies spawned on free cells of first chunk of new game
+    std::string level_enemy_name;
+    uint32_t level_enemies_count;
+
+    // Stress scenario spawns entities of this name when not empty
+    std::string stress_entity_name;
+    // Script given to stress entities whose prefab has none, scenario refuses them without it
+    std::string stress_script_name;
+    std::vector<uint32_t> stress_entities_counts;
+    uint32_t stress_ticks;
+    std::string stress_report_file_name;
+
+    // Seed of random engine, 0 takes seed of random device
+    uint32_t random_seed;
+    // Level input is recorded to this file when not empty
+    std::string input_record_file_name;
+    // Level input is played from this file when not empty, seed is taken from it
+    std::string input_replay_file_name;
+    // History of performance counters is written to this file on exit when not empty
+    std::string perf_counters_file_name;
+
     std::string level_keyboard_actions_file_name;
     std::string main_menu_keyboard_actions_file_name;
 
@@ -2,12 +2,11 @@
 #include "../components/components.h"
 #include "../damages/damages.h"
 #include "../entity_funcs.h"
+#include "../fck/random.h"
 #include "../fck/utilities.h"
 
 #include "spdlog/spdlog.h"
 
-#include <random>
-
 namespace fck::skill
 {
 
@@ -78,11 +77,9 @@ void BaseAttack::apply(const Entity &entity, const Entity &target)
 
     entity_funcs::setState(entity, entity_state::ATTACK);
 
-    std::random_device rd;
-    std::mt19937 mt(rd());
-    std::uniform_int_distribution<int32_t> dist(0, m_attack_animations.size() - 1);
-
-    entity_funcs::setDrawableState(m_entity, m_attack_animations[dist(mt)]);
+    entity_funcs::setDrawableState(
+        m_entity,
+        m_attack_animations[Random::uniformInt(0, int32_t(m_attack_animations.size() - 1))]);
     entity_funcs::stopAllSound(m_entity);
     entity_funcs::playSound(m_entity, entity_state::stateToString(entity_state::ATTACK));
 }
@@ -138,15 +135,16 @@ void BaseAttack::targetAttack(double delta_time)
                                                                                          : 100.0f,
                    0.0f};
 
-            std::random_device rd;
-            std::mt19937 mt(rd());
-            std::uniform_real_distribution<float> dist(m_damage.first, m_damage.second);
-
             component::Damage &target_damage_component = m_target.get<component::Damage>();
             if (!target_damage_component.damage)
             {
                 target_damage_component.damage.reset(
-                    new damage::BaseAttack(dist(mt), rebounce_velocity, m_target, 0.2, m_entity));
+                    new damage::BaseAttack(
+                        Random::uniformReal(m_damage.first, m_damage.second),
+                        rebounce_velocity,
+                        m_target,
+                        0.2,
+                        m_entity));
             }
         }
         m_target_attacked = true;
@@ -1,5 +1,8 @@
 #include "skill.h"
 
+#include "../fck/perf_counters.h"
+#include "../fck/profiler.h"
+
 namespace fck::skill
 {
 
@@ -68,6 +71,9 @@ void Skill::update(double delta_time)
 
     if (m_update_function)
     {
+        FCK_PROFILE_ZONE("Skill::update");
+        FCK_PERF_COUNTER_ADD("Lua calls", 1);
+
         auto result = m_update_function(m_skill_table, delta_time);
         if (!result.valid())
         {
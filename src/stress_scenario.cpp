@@ -0,0 +1,209 @@
+#include "stress_scenario.h"
+#include "components/components.h"
+#include "entity_funcs.h"
+#include "fck/profiler.h"
+
+#include <spdlog/spdlog.h>
+
+#include <fstream>
+#include <iomanip>
+#include <set>
+
+namespace fck
+{
+
+StressScenario::StressScenario(
+    const std::vector<uint32_t> &entities_counts,
+    uint32_t ticks_count,
+    const std::string &script_name,
+    const SpawnFunction &spawn_function)
+    : m_entities_counts{entities_counts},
+      m_ticks_count{ticks_count},
+      m_script_name{script_name},
+      m_spawn_function{spawn_function},
+      m_step_index{0},
+      m_step_tick{0}
+{
+}
+
+bool StressScenario::isFinished() const
+{
+    return m_step_index >= m_entities_counts.size();
+}
+
+void StressScenario::update(
+    const Entity &target, const std::vector<SystemScheduler::SystemTime> &system_times)
+{
+    if (isFinished())
+        return;
+
+    if (m_step_tick == 0)
+    {
+        startStep();
+        ++m_step_tick;
+        return;
+    }
+
+    Step &step = m_steps.back();
+
+    if (m_step_tick > WARMUP_TICKS)
+    {
+        step.frame_time += Profiler::getFrameTime();
+        for (const SystemScheduler::SystemTime &system_time : system_times)
+            step.system_times[system_time.name] += system_time.time;
+        ++step.ticks;
+
+        // Zones of many entities may wrap profiler buffers, partial stats are not reported
+        if (Profiler::isFrameStatsComplete())
+        {
+            for (const Profiler::ZoneStats &zone_stats : Profiler::getFrameStats())
+            {
+                if (step.system_times.count(zone_stats.name) == 0)
+                    step.zone_times[zone_stats.name] += zone_stats.total_time;
+            }
+            ++step.profiled_ticks;
+        }
+    }
+
+    if (step.ticks >= m_ticks_count)
+    {
+        finishStep();
+        return;
+    }
+
+    // Keep followers busy, scripts may stop following
+    if (target.isValid() && target.has<component::Transform>())
+    {
+        sf::Vector2f target_position
+            = target.get<component::Transform>().transform.getPosition();
+
+        for (Entity &entity : m_entities)
+        {
+            if (!entity.isValid())
+                continue;
+
+            auto &target_follow_component = entity.get<component::TargetFollow>();
+            target_follow_component.follow = true;
+            target_follow_component.target = target_position;
+        }
+    }
+
+    ++m_step_tick;
+}
+
+bool StressScenario::writeCsv(const std::string &file_name) const
+{
+    std::ofstream file{file_name};
+    if (!file.is_open())
+    {
+        spdlog::warn("Can't open file to write stress report: {}", file_name);
+        return false;
+    }
+
+    std::set<std::string> system_names;
+    std::set<std::string> zone_names;
+    for (const Step &step : m_steps)
+    {
+        for (const auto &it : step.system_times)
+            system_names.insert(it.first);
+        for (const auto &it : step.zone_times)
+            zone_names.insert(it.first);
+    }
+
+    file << "entities,ticks,profiled_ticks,frame";
+    for (const std::string &system_name : system_names)
+        file << "," << system_name;
+    for (const std::string &zone_name : zone_names)
+        file << "," << zone_name;
+    file << "\n";
+
+    auto write_time = [&file](const std::map<std::string, double> &times,
+                              const std::string &name,
+                              uint32_t ticks) {
+        auto times_found = times.find(name);
+        bool found = times_found != times.end() && ticks > 0;
+        file << "," << (found ? times_found->second / ticks : 0.0);
+    };
+
+    file << std::fixed << std::setprecision(4);
+    for (const Step &step : m_steps)
+    {
+        double ticks = step.ticks > 0 ? step.ticks : 1;
+
+        file << step.entities_count << "," << step.ticks << "," << step.profiled_ticks << ","
+             << step.frame_time / ticks;
+        for (const std::string &system_name : system_names)
+            write_time(step.system_times, system_name, step.ticks);
+        for (const std::string &zone_name : zone_names)
+            write_time(step.zone_times, zone_name, step.profiled_ticks);
+        file << "\n";
+    }
+
+    spdlog::info("Stress report written: {}", file_name);
+    return true;
+}
+
+void StressScenario::startStep()
+{
+    uint32_t entities_count = m_entities_counts[m_step_index];
+
+    spdlog::info("Stress step: {} entities, {} ticks", entities_count, m_ticks_count);
+
+    Profiler::setEnabled(true);
+
+    m_entities = m_spawn_function(entities_count);
+    for (Entity &entity : m_entities)
+    {
+        if (ensureComponents(entity))
+            continue;
+
+        // Entities without scripts would measure systems without their main load
+        spdlog::error(
+            "Stress scenario stopped, entities have no script, set it by --stress-script");
+        for (Entity &spawned_entity : m_entities)
+            spawned_entity.destroy();
+        m_entities.clear();
+        m_step_index = m_entities_counts.size();
+        return;
+    }
+
+    m_steps.push_back({uint32_t(m_entities.size()), 0, 0, 0.0, {}, {}});
+}
+
+void StressScenario::finishStep()
+{
+    const Step &step = m_steps.back();
+    spdlog::info(
+        "Stress step finished: {} entities, {:.3f} ms per tick",
+        step.entities_count,
+        step.ticks > 0 ? step.frame_time / step.ticks : 0.0);
+
+    for (Entity &entity : m_entities)
+        entity.destroy();
+    m_entities.clear();
+
+    ++m_step_index;
+    m_step_tick = 0;
+}
+
+bool StressScenario::ensureComponents(Entity &entity) const
+{
+    if (!entity.has<component::TargetFollow>())
+        entity.add<component::TargetFollow>().min_distance = 16.0f;
+
+    if (!entity.has<component::LookAround>())
+        entity.add<component::LookAround>().distance = 64.0f;
+
+    if (!entity.has<component::Collision>())
+        entity.add<component::Collision>();
+
+    if (!entity.has<component::Script>())
+        entity.add<component::Script>();
+
+    if (!entity.get<component::Script>().script && !m_script_name.empty())
+        entity_funcs::setScript(entity, m_script_name);
+
+    return entity.get<component::Script>().script != nullptr;
+}
+
+} // namespace fck
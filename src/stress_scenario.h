@@ -0,0 +1,80 @@
+#ifndef STRESSSCENARIO_ZBRQKTMWLYXE_H
+#define STRESSSCENARIO_ZBRQKTMWLYXE_H
+
+#include "fck/entity.h"
+#include "fck/system_scheduler.h"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace fck
+{
+
+// Spawns entities in steps of given counts and runs every step for given count of level
+// ticks. Spawned entities follow target, so pathfinding, broadphase and scripts work for
+// all of them. Times of scheduled systems give time per tick of every system vs count, other
+// profiler zones are added from ticks whose profiler stats are complete. Entities without
+// script get script of given name, scenario stops if they can't get it.
+class StressScenario
+{
+public:
+    // Spawns count entities and returns them
+    using SpawnFunction = std::function<std::vector<Entity>(int32_t)>;
+
+    StressScenario(
+        const std::vector<uint32_t> &entities_counts,
+        uint32_t ticks_count,
+        const std::string &script_name,
+        const SpawnFunction &spawn_function);
+    ~StressScenario() = default;
+
+    bool isFinished() const;
+
+    // Called every level tick before systems. System times and profiler stats are of previous
+    // tick.
+    void update(
+        const Entity &target, const std::vector<SystemScheduler::SystemTime> &system_times);
+
+    // One line per step: entities count, measured ticks, ticks with complete profiler stats,
+    // then ms per tick of every system and zone
+    bool writeCsv(const std::string &file_name) const;
+
+private:
+    struct Step
+    {
+        uint32_t entities_count;
+        uint32_t ticks;
+        uint32_t profiled_ticks;
+        double frame_time; // ms
+        std::map<std::string, double> system_times; // ms
+        std::map<std::string, double> zone_times; // ms
+    };
+
+    void startStep();
+    void finishStep();
+
+    // False if entity has no script and can't get it
+    bool ensureComponents(Entity &entity) const;
+
+private:
+    // Spawn tick and tick when systems get spawned entities are not measured
+    static constexpr uint32_t WARMUP_TICKS = 2;
+
+    std::vector<uint32_t> m_entities_counts;
+    uint32_t m_ticks_count;
+    std::string m_script_name;
+    SpawnFunction m_spawn_function;
+
+    std::size_t m_step_index;
+    uint32_t m_step_tick;
+    std::vector<Entity> m_entities;
+
+    std::vector<Step> m_steps;
+};
+
+} // namespace fck
+
+#endif // STRESSSCENARIO_ZBRQKTMWLYXE_H
@@ -32,106 +32,111 @@ struct Sweep
 
 Collision::Collision()
 {
+    // Tree is changed only when moves are flushed, collided signals are deferred
+    setExclusive(false);
+    reads<component::Scene, component::Collision>();
+    writes<component::Velocity, component::Transform>();
 }
 
 void Collision::update(double delta_time)
 {
-    for (Entity &entity : getEntities())
-    {
-        component::Scene &scene_component = entity.get<component::Scene>();
-        component::Velocity &velocity_component = entity.get<component::Velocity>();
-        component::Transform &transform_component = entity.get<component::Transform>();
-        component::Collision &collision_component = entity.get<component::Collision>();
-
-        if (!vector2::isValid(velocity_component.velocity))
-            continue;
-
-        sf::Vector2f delta = velocity_component.velocity * float(delta_time);
-        float delta_max = std::max(delta.x, delta.y);
-
-        bool collided = false;
-        sf::FloatRect global_bounds = scene_component.global_bounds;
-        sf::FloatRect querry_bounds = rect::extends(
-            scene_component.global_bounds, sf::Vector2f{std::abs(delta_max), std::abs(delta_max)});
-        querry_bounds
-            = rect::extends(querry_bounds, scene_component.global_bounds.getSize() / 2.0f);
-
-        sf::Vector2f position = rect::center(global_bounds);
-        sf::Vector2f delta_position = transform_component.transform.getPosition() - position;
-
-        Entity prev_not_wall_collided_entity;
-        for (int32_t i = 0; i < 2; ++i)
-        {
-            Sweep sweep;
-            int32_t foo = 1;
-            scene_component.tree->querry(querry_bounds, [&](int32_t id) {
-                Entity other = scene_component.tree->getUserData(id);
-                if (other != entity)
-                {
-                    if (!other.has<component::Collision>())
-                        return true;
+    each<component::Scene, component::Velocity, component::Transform>(
+        [delta_time](
+            Entity &entity,
+            component::Scene &scene_component,
+            component::Velocity &velocity_component,
+            component::Transform &transform_component) {
+            if (!vector2::isValid(velocity_component.velocity))
+                return;
+
+            sf::Vector2f delta = velocity_component.velocity * float(delta_time);
+            float delta_max = std::max(delta.x, delta.y);
+
+            bool collided = false;
+            // Cached bounds follow moves only after flush, so take them from transform
+            sf::FloatRect global_bounds = transform_component.transform.getTransform().transformRect(
+                scene_component.local_bounds);
+            sf::FloatRect querry_bounds = rect::extends(
+                global_bounds,
+                sf::Vector2f{std::abs(delta_max), std::abs(delta_max)});
+            querry_bounds = rect::extends(querry_bounds, global_bounds.getSize() / 2.0f);
+
+            sf::Vector2f position = rect::center(global_bounds);
+            sf::Vector2f delta_position = transform_component.transform.getPosition() - position;
+
+            Entity prev_not_wall_collided_entity;
+            for (int32_t i = 0; i < 2; ++i)
+            {
+                Sweep sweep;
+                int32_t foo = 1;
+                scene_component.tree->querry(querry_bounds, [&](int32_t id) {
+                    Entity other = scene_component.tree->getUserData(id);
+                    if (other != entity)
+                    {
+                        if (!other.has<component::Collision>())
+                            return true;
 
-                    component::Collision &other_collision_component
-                        = other.get<component::Collision>();
+                        component::Collision &other_collision_component
+                            = other.get<component::Collision>();
 
-                    collisions::AABB other_aabb{other.get<component::Scene>().global_bounds};
-                    other_aabb.half += scene_component.global_bounds.getSize() / 2.0f;
+                        collisions::AABB other_aabb{other.get<component::Scene>().global_bounds};
+                        other_aabb.half += scene_component.global_bounds.getSize() / 2.0f;
 
-                    auto hit = other_aabb.intersectSegment(position, delta);
+                        auto hit = other_aabb.intersectSegment(position, delta);
 
-                    if (hit)
-                    {
-                        if (!other_collision_component.wall && hit->time != 0)
+                        if (hit)
                         {
-                            if (prev_not_wall_collided_entity == other)
+                            if (!other_collision_component.wall && hit->time != 0)
+                            {
+                                if (prev_not_wall_collided_entity == other)
+                                    return true;
+
+                                prev_not_wall_collided_entity = other;
+                                entity_funcs::emit(entity_funcs::collided, entity, other);
+                                entity_funcs::emit(entity_funcs::collided, other, entity);
                                 return true;
+                            }
 
-                            prev_not_wall_collided_entity = other;
-                            entity_funcs::collided(entity, other);
-                            entity_funcs::collided(other, entity);
-                            return true;
+                            sweep.setHit(hit, other);
                         }
-
-                        sweep.setHit(hit, other);
                     }
-                }
-                return true;
-            });
+                    return true;
+                });
 
-            if (sweep.hit)
-            {
-                entity_funcs::collided(entity, sweep.entity);
-                entity_funcs::collided(sweep.entity, entity);
+                if (sweep.hit)
+                {
+                    entity_funcs::emit(entity_funcs::collided, entity, sweep.entity);
+                    entity_funcs::emit(entity_funcs::collided, sweep.entity, entity);
 
-                position = sweep.hit->position + sweep.hit->normal;
+                    position = sweep.hit->position + sweep.hit->normal;
 
-                if (sweep.hit->normal.x != 0)
-                {
-                    collided = true;
-                    position.y += delta.y;
-                    delta.x = 0;
-                    velocity_component.velocity.x = 0;
-                }
-                else if (sweep.hit->normal.y != 0)
-                {
-                    collided = true;
-                    position.x += delta.x;
-                    delta.y = 0;
-                    velocity_component.velocity.y = 0;
-                }
+                    if (sweep.hit->normal.x != 0)
+                    {
+                        collided = true;
+                        position.y += delta.y;
+                        delta.x = 0;
+                        velocity_component.velocity.x = 0;
+                    }
+                    else if (sweep.hit->normal.y != 0)
+                    {
+                        collided = true;
+                        position.x += delta.x;
+                        delta.y = 0;
+                        velocity_component.velocity.y = 0;
+                    }
 
-                rect::setCenter(global_bounds, position);
-                rect::setCenter(querry_bounds, position);
+                    rect::setCenter(global_bounds, position);
+                    rect::setCenter(querry_bounds, position);
+                }
             }
-        }
 
-        if (collided)
-        {
-            position -= velocity_component.velocity * float(delta_time) * 1.2f;
-            position += delta_position;
-            entity_funcs::setPosition(entity, position);
-        }
-    }
+            if (collided)
+            {
+                position -= velocity_component.velocity * float(delta_time) * 1.2f;
+                position += delta_position;
+                entity_funcs::setPosition(entity, position);
+            }
+        });
 }
 
 } // namespace fck::system
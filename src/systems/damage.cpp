@@ -5,18 +5,24 @@ namespace fck::system
 
 Damage::Damage()
 {
+    // Damages change components of their entity only, signals are emitted by command buffer
+    setExclusive(false);
+    writes<
+        component::Damage,
+        component::Stats,
+        component::State,
+        component::Velocity,
+        component::Drawable,
+        component::DrawableState,
+        component::DrawableAnimation>();
 }
 
 void Damage::update(double delta_time)
 {
-    for (Entity &entity : getEntities())
-    {
-        component::Damage &damage_cometent = entity.get<component::Damage>();
-
+    each<component::Damage>([delta_time](Entity &entity, component::Damage &damage_cometent) {
         if (damage_cometent.damage)
         {
-            component::State &state_component
-                = entity.get<component::State>();
+            component::State &state_component = entity.get<component::State>();
             if (state_component.state != entity_state::DEATH)
             {
                 damage_cometent.damage->_update(delta_time);
@@ -28,7 +34,7 @@ void Damage::update(double delta_time)
                 damage_cometent.damage.reset();
             }
         }
-    }
+    });
 }
 
 } // namespace fck::system
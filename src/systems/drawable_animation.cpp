@@ -3,8 +3,11 @@
 namespace fck::system
 {
 
-DrawableAnimation::DrawableAnimation()
+// Every animation is updated by itself
+DrawableAnimation::DrawableAnimation() : System{MembershipOrder::UNORDERED}
 {
+    setExclusive(false);
+    writes<component::DrawableAnimation, component::Drawable>();
 }
 
 void DrawableAnimation::update(const sf::Time &elapsed)
@@ -1,56 +1,77 @@
 #include "look_around.h"
 #include "../fck/utilities.h"
+#include "../fck/world.h"
 
 namespace fck::system
 {
 
-LookAround::LookAround(b2::DynamicTree<Entity> *tree) : m_tree{tree}
+// Found entities come in order of tree, not of system entities
+LookAround::LookAround(b2::DynamicTree<Entity> *tree)
+    : System{MembershipOrder::UNORDERED}, m_tree{tree}, m_last_tick{0}
 {
+    // Tree is changed only by exclusive systems, so it is safe to querry it here
+    setExclusive(false);
+    reads<component::Transform, component::State, component::Scene>();
+    writes<component::LookAround>();
 }
 
 void LookAround::update(double delta_time)
 {
-    for (Entity &entity : getEntities())
-    {
-        component::LookAround &look_around_component = entity.get<component::LookAround>();
+    // Bounds follow entities moved or turned since previous update
+    uint32_t last_tick = m_last_tick;
+    m_last_tick = getWorld()->getTick();
 
-        look_around_component.found_entities.clear();
-        look_around_component.look_at_entities.clear();
+    view<component::LookAround, component::Transform, component::State>()
+        .changed<component::Transform, component::State>(last_tick)
+        .each([this](
+                  component::LookAround &look_around_component,
+                  component::Transform &transform_component,
+                  component::State &state_component) {
+            updateBounds(look_around_component, transform_component, state_component);
+        });
+
+    each<component::LookAround>(
+        [this](Entity &entity, component::LookAround &look_around_component) {
+            look_around_component.found_entities.clear();
+            look_around_component.look_at_entities.clear();
 
-        if (!look_around_component.enable)
-            continue;
+            if (!look_around_component.enable)
+                return;
 
-        m_tree->querry(look_around_component.global_bounds, [&](int32_t id) {
-            Entity other = m_tree->getUserData(id);
-            if (other != entity)
-            {
-                if (!other.has<component::State>())
-                    return true;
+            m_tree->querry(look_around_component.global_bounds, [&](int32_t id) {
+                Entity other = m_tree->getUserData(id);
+                if (other != entity)
+                {
+                    if (!other.has<component::State>())
+                        return true;
 
-                look_around_component.found_entities.push_back(other);
+                    look_around_component.found_entities.push_back(other);
 
-                component::Scene &other_scene_component = other.get<component::Scene>();
-                if (look_around_component.global_look_bounds
-                        .findIntersection(other_scene_component.global_bounds)
-                        .has_value())
-                    look_around_component.look_at_entities.push_back(other);
-            }
+                    component::Scene &other_scene_component = other.get<component::Scene>();
+                    if (look_around_component.global_look_bounds
+                            .findIntersection(other_scene_component.global_bounds)
+                            .has_value())
+                        look_around_component.look_at_entities.push_back(other);
+                }
 
-            return true;
+                return true;
+            });
         });
-    }
 }
 
-void LookAround::updateBounds(const Entity &entity)
+void LookAround::onEntityAdded(Entity &entity)
 {
-    if (!entity.has<component::LookAround>() || !entity.has<component::State>()
-        || !entity.has<component::Transform>())
-        return;
-
-    auto &look_around_component = entity.get<component::LookAround>();
-    auto &state_component = entity.get<component::State>();
-    auto &transform_component = entity.get<component::Transform>();
+    updateBounds(
+        entity.get<component::LookAround>(),
+        entity.get<component::Transform>(),
+        entity.get<component::State>());
+}
 
+void LookAround::updateBounds(
+    component::LookAround &look_around_component,
+    const component::Transform &transform_component,
+    const component::State &state_component)
+{
     sf::Vector2f global_position = transform_component.transform.getPosition();
 
     look_around_component.global_bounds
@@ -17,10 +17,19 @@ public:
 
     void update(double delta_time);
 
-    void updateBounds(const Entity &entity);
+protected:
+    // Entities enabled later than they were changed aren't found by changed ticks
+    void onEntityAdded(Entity &entity);
+
+private:
+    void updateBounds(
+        component::LookAround &look_around_component,
+        const component::Transform &transform_component,
+        const component::State &state_component);
 
 private:
     b2::DynamicTree<Entity> *m_tree;
+    uint32_t m_last_tick;
 };
 
 } // namespace fck::system
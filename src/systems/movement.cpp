@@ -11,20 +11,21 @@ namespace fck::system
 
 Movement::Movement()
 {
+    setExclusive(false);
+    reads<component::Velocity>();
+    writes<component::Transform>();
 }
 
 void Movement::update(double delta_time)
 {
-    for (Entity &entity : getEntities())
-    {
-        component::Velocity &velocity_component = entity.get<component::Velocity>();
-
-        if (vector2::isValid(velocity_component.velocity))
-        {
-            sf::Vector2f result_velocity = velocity_component.velocity * float(delta_time);
-            entity_funcs::move(entity, result_velocity);
-        }
-    }
+    each<component::Velocity>(
+        [delta_time](Entity &entity, component::Velocity &velocity_component) {
+            if (vector2::isValid(velocity_component.velocity))
+            {
+                sf::Vector2f result_velocity = velocity_component.velocity * float(delta_time);
+                entity_funcs::move(entity, result_velocity);
+            }
+        });
 }
 
 void Movement::onEntityStateChanged(const Entity &entity, entity_state::State state)
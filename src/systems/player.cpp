@@ -9,6 +9,14 @@ namespace fck::system
 
 Player::Player() : m_move_direction{0}
 {
+    // Move direction is changed by slots on main thread, between updates
+    setExclusive(false);
+    writes<
+        component::Velocity,
+        component::State,
+        component::Drawable,
+        component::DrawableState,
+        component::DrawableAnimation>();
 }
 
 void Player::update(double delta_time)
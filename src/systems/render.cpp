@@ -1,34 +1,49 @@
 #include "render.h"
 
+#include "../fck/utilities.h"
+#include "../fck/world.h"
+
 #include <spdlog/spdlog.h>
 
 namespace fck::system
 {
 
-Render::Render(b2::DynamicTree<Entity> *tree) : m_tree{tree}
+Render::Render(b2::DynamicTree<Entity> *tree) : m_tree{tree}, m_last_tick{0}
 {
+    setExclusive(false);
+    reads<component::Transform>();
+    writes<component::Drawable>();
 }
 
-void Render::onEntityMoved(const Entity &entity, const sf::Vector2f &offset)
+void Render::update(double delta_time)
 {
-    if (!entity.has<component::Drawable>() || !entity.has<component::Transform>())
-        return;
-
-    auto &drawable_component = entity.get<component::Drawable>();
-    if (!drawable_component.proxy)
-        return;
-
-    auto &transform_component = entity.get<component::Transform>();
-
-    if (drawable_component.z_order_fill_y_coordinate)
-        drawable_component.z_order = transform_component.transform.getPosition().y + Z_ORDER;
-
-    drawable_component.global_bounds = transform_component.transform.getTransform().transformRect(
-        drawable_component.proxy->getGlobalBounds());
-
-    if (drawable_component.tree_id > -1)
-        drawable_component.tree->moveProxy(
-            drawable_component.tree_id, drawable_component.global_bounds, offset);
+    // Changes made after previous update have its tick or later
+    uint32_t last_tick = m_last_tick;
+    m_last_tick = getWorld()->getTick();
+
+    view<component::Drawable, component::Transform>()
+        .changed<component::Transform>(last_tick)
+        .each([](component::Drawable &drawable_component,
+                 component::Transform &transform_component) {
+            if (!drawable_component.proxy)
+                return;
+
+            if (drawable_component.z_order_fill_y_coordinate)
+                drawable_component.z_order
+                    = transform_component.transform.getPosition().y + Z_ORDER;
+
+            sf::Vector2f old_center = rect::center(drawable_component.global_bounds);
+
+            drawable_component.global_bounds
+                = transform_component.transform.getTransform().transformRect(
+                    drawable_component.proxy->getGlobalBounds());
+
+            if (drawable_component.tree_id > -1)
+                drawable_component.tree->moveProxy(
+                    drawable_component.tree_id,
+                    drawable_component.global_bounds,
+                    rect::center(drawable_component.global_bounds) - old_center);
+        });
 }
 
 void Render::onEntityDirectionChanged(const Entity &entity, entity_state::Direction direction)
@@ -49,6 +64,10 @@ void Render::onEntityAdded(Entity &entity)
     auto &transform_component = entity.get<component::Transform>();
     auto &drawable_component = entity.get<component::Drawable>();
 
+    // Drawables have no proxy without loaded resources (headless), they aren't drawn
+    if (!drawable_component.proxy)
+        return;
+
     drawable_component.global_bounds = transform_component.transform.getTransform().transformRect(
         drawable_component.proxy->getGlobalBounds());
 
@@ -56,9 +75,44 @@ void Render::onEntityAdded(Entity &entity)
     drawable_component.tree = m_tree;
 }
 
+void Render::onEntitiesAdded(std::vector<Entity> &entities)
+{
+    std::vector<b2::AABB> aabbs;
+    aabbs.reserve(entities.size());
+    std::vector<Entity> drawn_entities;
+    drawn_entities.reserve(entities.size());
+
+    for (Entity &entity : entities)
+    {
+        auto &transform_component = entity.get<component::Transform>();
+        auto &drawable_component = entity.get<component::Drawable>();
+
+        if (!drawable_component.proxy)
+            continue;
+
+        drawable_component.global_bounds
+            = transform_component.transform.getTransform().transformRect(
+                drawable_component.proxy->getGlobalBounds());
+
+        aabbs.push_back(drawable_component.global_bounds);
+        drawn_entities.push_back(entity);
+    }
+
+    std::vector<int32_t> proxy_ids = m_tree->createProxies(aabbs, drawn_entities);
+
+    for (std::size_t i = 0; i < drawn_entities.size(); ++i)
+    {
+        auto &drawable_component = drawn_entities[i].get<component::Drawable>();
+        drawable_component.tree_id = proxy_ids[i];
+        drawable_component.tree = m_tree;
+    }
+}
+
 void Render::onEntityRemoved(Entity &entity)
 {
     auto &drawable_component = entity.get<component::Drawable>();
+    if (drawable_component.tree_id == -1)
+        return;
 
     m_tree->destroyProxy(drawable_component.tree_id);
     drawable_component.tree_id = -1;
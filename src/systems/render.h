@@ -15,17 +15,19 @@ public:
     Render(b2::DynamicTree<Entity> *tree);
     ~Render() = default;
 
-public: // slots
-    void onEntityMoved(const Entity &entity, const sf::Vector2f &offset);
+    void update(double delta_time);
 
+public: // slots
     void onEntityDirectionChanged(const Entity &entity, entity_state::Direction direction);
 
 protected:
     void onEntityAdded(Entity &entity);
     void onEntityRemoved(Entity &entity);
+    void onEntitiesAdded(std::vector<Entity> &entities);
 
 private:
     b2::DynamicTree<Entity> *m_tree;
+    uint32_t m_last_tick;
 };
 
 } // namespace fck::system
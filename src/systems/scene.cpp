@@ -7,19 +7,32 @@ Scene::Scene(b2::DynamicTree<Entity> *tree) : m_tree{tree}
 {
 }
 
-void Scene::onEntityMoved(const Entity &entity, const sf::Vector2f &offset)
+void Scene::onEntitiesMoved(const std::vector<entity_funcs::Moved> &moved)
 {
-    if (!entity.has<component::Scene>() || !entity.has<component::Transform>())
-        return;
+    std::vector<int32_t> proxy_ids;
+    std::vector<b2::AABB> aabbs;
+    std::vector<sf::Vector2f> displacements;
 
-    auto &scene_component = entity.get<component::Scene>();
-    auto &transform_component = entity.get<component::Transform>();
+    for (const entity_funcs::Moved &it : moved)
+    {
+        if (!it.entity.has<component::Scene>() || !it.entity.has<component::Transform>())
+            continue;
 
-    scene_component.global_bounds
-        = transform_component.transform.getTransform().transformRect(scene_component.local_bounds);
+        auto &scene_component = it.entity.get<component::Scene>();
+        auto &transform_component = it.entity.get<component::Transform>();
 
-    if (scene_component.tree_id > -1)
-        m_tree->moveProxy(scene_component.tree_id, scene_component.global_bounds, offset);
+        scene_component.global_bounds = transform_component.transform.getTransform().transformRect(
+            scene_component.local_bounds);
+
+        if (scene_component.tree_id < 0)
+            continue;
+
+        proxy_ids.push_back(scene_component.tree_id);
+        aabbs.push_back(scene_component.global_bounds);
+        displacements.push_back(it.offset);
+    }
+
+    m_tree->moveProxies(proxy_ids, aabbs, displacements);
 }
 
 void Scene::onEntityAdded(Entity &entity)
@@ -34,6 +47,32 @@ void Scene::onEntityAdded(Entity &entity)
     scene_component.tree = m_tree;
 }
 
+void Scene::onEntitiesAdded(std::vector<Entity> &entities)
+{
+    std::vector<b2::AABB> aabbs;
+    aabbs.reserve(entities.size());
+
+    for (Entity &entity : entities)
+    {
+        auto &transform_component = entity.get<component::Transform>();
+        auto &scene_component = entity.get<component::Scene>();
+
+        scene_component.global_bounds = transform_component.transform.getTransform().transformRect(
+            scene_component.local_bounds);
+
+        aabbs.push_back(scene_component.global_bounds);
+    }
+
+    std::vector<int32_t> proxy_ids = m_tree->createProxies(aabbs, entities);
+
+    for (std::size_t i = 0; i < entities.size(); ++i)
+    {
+        auto &scene_component = entities[i].get<component::Scene>();
+        scene_component.tree_id = proxy_ids[i];
+        scene_component.tree = m_tree;
+    }
+}
+
 void Scene::onEntityRemoved(Entity &entity)
 {
     auto &scene_component = entity.get<component::Scene>();
@@ -2,6 +2,7 @@
 #define SCENE_TJFEPRLODBPB_H
 
 #include "../components/components.h"
+#include "../entity_funcs.h"
 
 #include "../fck/a_star.h"
 #include "../fck/b2_dynamic_tree.h"
@@ -17,11 +18,12 @@ public:
     ~Scene() = default;
 
 public: // slots
-    void onEntityMoved(const Entity &entity, const sf::Vector2f &offset);
+    void onEntitiesMoved(const std::vector<entity_funcs::Moved> &moved);
 
 protected:
     void onEntityAdded(Entity &entity);
     void onEntityRemoved(Entity &entity);
+    void onEntitiesAdded(std::vector<Entity> &entities);
 
 private:
     b2::DynamicTree<Entity> *m_tree;
@@ -49,6 +49,12 @@ void Script::onEntityDestroyed(const Entity &entity)
         script_component.script->onEntityDestroyed();
 }
 
+void Script::onEntitiesMoved(const std::vector<entity_funcs::Moved> &moved)
+{
+    for (const entity_funcs::Moved &it : moved)
+        onEntityMoved(it.entity, it.offset);
+}
+
 void Script::onEntityMoved(const Entity &entity, const sf::Vector2f &offset)
 {
     if (!entity.has<component::Script>())
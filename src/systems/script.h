@@ -2,6 +2,7 @@
 #define SCRIPT_DAWQCBFULHWB_H
 
 #include "../components/components.h"
+#include "../entity_funcs.h"
 #include "../fck/system.h"
 #include "../map/map.h"
 
@@ -24,7 +25,7 @@ public: // slots
     void onEntityDisabled(const Entity &entity);
     void onEntityDestroyed(const Entity &entity);
 
-    void onEntityMoved(const Entity &entity, const sf::Vector2f &offset);
+    void onEntitiesMoved(const std::vector<entity_funcs::Moved> &moved);
 
     void onEntityStateChanged(const Entity &entity, entity_state::State state);
     void onEntityDirectionChanged(const Entity &entity, entity_state::Direction direction);
@@ -34,6 +35,9 @@ public: // slots
     // map
     void onMapChanged(map::Map *map);
 
+private:
+    void onEntityMoved(const Entity &entity, const sf::Vector2f &offset);
+
 private:
     sol::state *m_sol_state;
 };
@@ -11,10 +11,7 @@ Skills::Skills()
 
 void Skills::update(double delta_time)
 {
-    for (Entity &entity : getEntities())
-    {
-        component::Skills &skills_component = entity.get<component::Skills>();
-
+    each<component::Skills>([delta_time](Entity &entity, component::Skills &skills_component) {
         if (skills_component.next_skill != -1)
         {
             component::State &state_component = entity.get<component::State>();
@@ -54,7 +51,7 @@ void Skills::update(double delta_time)
                     entity_funcs::skill_finished(entity, skill.get());
             }
         }
-    }
+    });
 }
 
 } // namespace fck::system
@@ -11,6 +11,12 @@ Sound::Sound()
     sf::Listener::setGlobalVolume(100);
 }
 
+void Sound::onEntitiesMoved(const std::vector<entity_funcs::Moved> &moved)
+{
+    for (const entity_funcs::Moved &it : moved)
+        onEntityMoved(it.entity, it.offset);
+}
+
 void Sound::onEntityMoved(const Entity &entity, const sf::Vector2f &offset)
 {
     if (entity.has<component::Player>())
@@ -2,6 +2,7 @@
 #define SOUND_UVHPRTOHNRHM_H
 
 #include "../components/components.h"
+#include "../entity_funcs.h"
 #include "../fck/system.h"
 
 namespace fck::system
@@ -14,6 +15,9 @@ public:
     ~Sound() = default;
 
 public: //slots
+    void onEntitiesMoved(const std::vector<entity_funcs::Moved> &moved);
+
+private:
     void onEntityMoved(const Entity &entity, const sf::Vector2f &offset);
 };
 
@@ -14,6 +14,7 @@
 #include "sound.h"
 #include "stats.h"
 #include "target_follow.h"
+#include "transform_hierarchy.h"
 #include "view_movement.h"
 
 #endif // SYSTEMS_XXUMQMOBDUCG_H
@@ -1,161 +1,204 @@
 #include "target_follow.h"
 #include "../entity_funcs.h"
-#include "../fck/a_star.h"
 #include "../fck/utilities.h"
 
+#include <algorithm>
+
 namespace fck::system
 {
 
 TargetFollow::TargetFollow() : m_map{nullptr}, m_walls{nullptr}
 {
+    // Chunk walls are uniform-cost grids
+    m_path_requests.setAlgorithm(PathFinder::JUMP_POINT_SEARCH);
+    // Followers and their targets move a little between requests, so search trees are reused
+    m_path_requests.setIncrementalReplanning(true);
+
+    // Map and chunk are changed by slots on main thread, paths are owned by system
+    setExclusive(false);
+    reads<component::Transform>();
+    writes<
+        component::TargetFollow,
+        component::Velocity,
+        component::State,
+        component::Drawable,
+        component::DrawableState,
+        component::DrawableAnimation>();
 }
 
 void TargetFollow::update(double delta_time)
 {
-    for (Entity &entity : getEntities())
-    {
-        component::TargetFollow &target_follow_component = entity.get<component::TargetFollow>();
-        component::Transform &transform_component = entity.get<component::Transform>();
-        component::Velocity &velocity_component = entity.get<component::Velocity>();
-        component::State &state_component = entity.get<component::State>();
+    deliverPaths();
+    countTargetFollowers();
 
-        if (!target_follow_component.follow || !m_walls)
-        {
-            if (!target_follow_component.path.empty())
+    each<component::TargetFollow, component::Transform, component::Velocity, component::State>(
+        [this](
+            Entity &entity,
+            component::TargetFollow &target_follow_component,
+            component::Transform &transform_component,
+            component::Velocity &velocity_component,
+            component::State &state_component) {
+            if (!target_follow_component.follow || !m_walls)
             {
-                target_follow_component.path.clear();
-                target_follow_component.state = component::TargetFollow::LOST;
-                velocity_component.velocity = {0.0f, 0.0f};
-                entity_funcs::setState(entity, entity_state::IDLE);
-                entity_funcs::setDrawableState(
-                    entity, entity_state::stateToString(entity_state::IDLE));
-                entity_funcs::stopSound(entity, entity_state::stateToString(entity_state::MOVE));
+                if (!target_follow_component.path.empty())
+                {
+                    target_follow_component.path.clear();
+                    target_follow_component.state = component::TargetFollow::LOST;
+                    velocity_component.velocity = {0.0f, 0.0f};
+                    entity_funcs::setState(entity, entity_state::IDLE);
+                    entity_funcs::setDrawableState(
+                        entity, entity_state::stateToString(entity_state::IDLE));
+                    entity_funcs::stopSound(
+                        entity, entity_state::stateToString(entity_state::MOVE));
+                }
+                return;
             }
-            continue;
-        }
 
-        float dist_to_target = vector2::distance(
-            transform_component.transform.getPosition(), target_follow_component.target);
+            float dist_to_target = vector2::distance(
+                transform_component.transform.getPosition(), target_follow_component.target);
 
-        if (target_follow_component.state == component::TargetFollow::RICHED
-            && dist_to_target < target_follow_component.min_distance * 1.5f)
-            continue;
+            if (target_follow_component.state == component::TargetFollow::RICHED
+                && dist_to_target < target_follow_component.min_distance * 1.5f)
+                return;
 
-        target_follow_component.state = component::TargetFollow::LOST;
-        velocity_component.velocity = {0.0f, 0.0f};
+            target_follow_component.state = component::TargetFollow::LOST;
+            velocity_component.velocity = {0.0f, 0.0f};
 
-        sf::Vector2i target_coord = transformPosition(target_follow_component.target);
+            sf::Vector2i target_coord = transformPosition(target_follow_component.target);
+            bool flow_field_follow
+                = m_target_followers[cellKey(target_coord)] >= FLOW_FIELD_MIN_FOLLOWERS;
 
-        // Need update path
-        if ((target_follow_component.path.empty()
-             || target_follow_component.path.front() != target_coord)
-            && dist_to_target > target_follow_component.min_distance)
-        {
-            // Check cell reachable
-            int32_t cell_weight = m_walls->getData(target_coord);
-            if (cell_weight != 0)
+            // Need update path, followers of shared flow field read next cell every step
+            if ((flow_field_follow || target_follow_component.path.empty()
+                 || target_follow_component.path.front() != target_coord)
+                && dist_to_target > target_follow_component.min_distance)
             {
-                static std::vector<sf::Vector2i> neighbor_coords
-                    = {{-1, 0}, {0, -1}, {0, 1}, {0, 1}};
-                for (const sf::Vector2i &neighbor_coord : neighbor_coords)
+                // Check cell reachable
+                int32_t cell_weight = m_walls->getData(target_coord);
+                if (cell_weight != 0)
                 {
-                    const int32_t &neighbor_cell_weight
-                        = m_walls->getData(target_coord + neighbor_coord);
-                    if (neighbor_cell_weight == 0)
+                    static std::vector<sf::Vector2i> neighbor_coords
+                        = {{-1, 0}, {0, -1}, {0, 1}, {0, 1}};
+                    for (const sf::Vector2i &neighbor_coord : neighbor_coords)
                     {
-                        target_coord = target_coord + neighbor_coord;
-                        cell_weight = neighbor_cell_weight;
-                        break;
+                        const int32_t &neighbor_cell_weight
+                            = m_walls->getData(target_coord + neighbor_coord);
+                        if (neighbor_cell_weight == 0)
+                        {
+                            target_coord = target_coord + neighbor_coord;
+                            cell_weight = neighbor_cell_weight;
+                            break;
+                        }
                     }
                 }
-            }
 
-            if (cell_weight == 0)
-            {
-                PathFinder path_finder{*m_walls};
-                target_follow_component.path = path_finder.findPath(
-                    transformPosition(transform_component.transform.getPosition()), target_coord);
+                if (cell_weight == 0)
+                {
+                    sf::Vector2i source_coord
+                        = transformPosition(transform_component.transform.getPosition());
 
-                if (!target_follow_component.path.empty())
-                    target_follow_component.path.erase(target_follow_component.path.end() - 1);
+                    if (flow_field_follow)
+                    {
+                        // Path keeps only next cell, whole path isn't built
+                        sf::Vector2i next_coord = getFlowField(target_coord).getNext(source_coord);
+
+                        target_follow_component.path.clear();
+                        if (next_coord != source_coord)
+                            target_follow_component.path.push_back(next_coord);
+                    }
+                    else if (!m_path_requests.isPending(entity, target_coord))
+                    {
+                        // Follower keeps moving by stale path until new one is delivered
+                        m_path_requests.submit(
+                            entity,
+                            source_coord,
+                            target_coord,
+                            target_follow_component.path.empty() ? 1 : 0);
+                    }
+                }
             }
-        }
 
-        if (target_follow_component.path.empty())
-        {
-            entity_funcs::setState(entity, entity_state::IDLE);
-            continue;
-        }
+            if (target_follow_component.path.empty())
+            {
+                entity_funcs::setState(entity, entity_state::IDLE);
+                return;
+            }
 
-        if (dist_to_target > target_follow_component.min_distance)
-        {
-            sf::Vector2f path_point = {-1, -1};
-            while (!target_follow_component.path.empty())
+            if (dist_to_target > target_follow_component.min_distance)
             {
-                sf::Vector2f next_path_point = sf::Vector2f{
-                    sf::Vector2i{
-                        target_follow_component.path.back().x * m_wall_size.x,
-                        target_follow_component.path.back().y * m_wall_size.y}
-                    + m_wall_size / 2};
+                sf::Vector2f path_point = {-1, -1};
+                while (!target_follow_component.path.empty())
+                {
+                    sf::Vector2f next_path_point = sf::Vector2f{
+                        sf::Vector2i{
+                            target_follow_component.path.back().x * m_wall_size.x,
+                            target_follow_component.path.back().y * m_wall_size.y}
+                        + m_wall_size / 2};
 
-                float dist_to_next_point = vector2::distance(
-                    transform_component.transform.getPosition(), next_path_point);
+                    float dist_to_next_point = vector2::distance(
+                        transform_component.transform.getPosition(), next_path_point);
 
-                if (dist_to_next_point < (m_wall_size.x / 4))
-                {
-                    target_follow_component.path.erase(target_follow_component.path.end() - 1);
+                    if (dist_to_next_point < (m_wall_size.x / 4))
+                    {
+                        target_follow_component.path.erase(target_follow_component.path.end() - 1);
+                    }
+                    else
+                    {
+                        path_point = next_path_point;
+                        break;
+                    }
                 }
-                else
+
+                if (path_point != sf::Vector2f{-1, -1})
                 {
-                    path_point = next_path_point;
-                    break;
-                }
-            }
+                    float angle
+                        = vector2::angleTo(transform_component.transform.getPosition(), path_point);
 
-            if (path_point != sf::Vector2f{-1, -1})
-            {
-                float angle
-                    = vector2::angleTo(transform_component.transform.getPosition(), path_point);
+                    velocity_component.velocity
+                        = {-velocity_component.max_velocity.x * std::cos(angle),
+                           -velocity_component.max_velocity.y * std::sin(angle)};
 
-                velocity_component.velocity
-                    = {-velocity_component.max_velocity.x * std::cos(angle),
-                       -velocity_component.max_velocity.y * std::sin(angle)};
+                    if ((velocity_component.velocity.x != 0 || velocity_component.velocity.y != 0)
+                        && state_component.state != entity_state::MOVE)
+                    {
+                        entity_funcs::setState(entity, entity_state::MOVE);
+                        entity_funcs::setDrawableState(
+                            entity, entity_state::stateToString(entity_state::MOVE));
+                        entity_funcs::playSound(
+                            entity, entity_state::stateToString(entity_state::MOVE));
+                    }
+                    else if (
+                        !vector2::isValid(velocity_component.velocity)
+                        && state_component.state != entity_state::IDLE)
+                    {
+                        entity_funcs::setState(entity, entity_state::IDLE);
+                        entity_funcs::setDrawableState(
+                            entity, entity_state::stateToString(entity_state::IDLE));
+                        entity_funcs::stopSound(
+                            entity, entity_state::stateToString(entity_state::MOVE));
+                    }
 
-                if ((velocity_component.velocity.x != 0 || velocity_component.velocity.y != 0)
-                    && state_component.state != entity_state::MOVE)
-                {
-                    entity_funcs::setState(entity, entity_state::MOVE);
-                    entity_funcs::setDrawableState(
-                        entity, entity_state::stateToString(entity_state::MOVE));
-                    entity_funcs::playSound(
-                        entity, entity_state::stateToString(entity_state::MOVE));
-                }
-                else if (
-                    !vector2::isValid(velocity_component.velocity)
-                    && state_component.state != entity_state::IDLE)
-                {
-                    entity_funcs::setState(entity, entity_state::IDLE);
-                    entity_funcs::setDrawableState(
-                        entity, entity_state::stateToString(entity_state::IDLE));
-                    entity_funcs::stopSound(
-                        entity, entity_state::stateToString(entity_state::MOVE));
+                    if (velocity_component.velocity.x > 0)
+                        entity_funcs::setDirection(entity, entity_state::RIGHT);
+                    else if (velocity_component.velocity.x < 0)
+                        entity_funcs::setDirection(entity, entity_state::LEFT);
                 }
-
-                if (velocity_component.velocity.x > 0)
-                    entity_funcs::setDirection(entity, entity_state::RIGHT);
-                else if (velocity_component.velocity.x < 0)
-                    entity_funcs::setDirection(entity, entity_state::LEFT);
             }
-        }
-        else
-        {
-            target_follow_component.path.clear();
-            target_follow_component.state = component::TargetFollow::RICHED;
-            entity_funcs::setState(entity, entity_state::IDLE);
-            entity_funcs::setDrawableState(entity, entity_state::stateToString(entity_state::IDLE));
-            entity_funcs::stopSound(entity, entity_state::stateToString(entity_state::MOVE));
-        }
-    }
+            else
+            {
+                target_follow_component.path.clear();
+                target_follow_component.state = component::TargetFollow::RICHED;
+                entity_funcs::setState(entity, entity_state::IDLE);
+                entity_funcs::setDrawableState(
+                    entity, entity_state::stateToString(entity_state::IDLE));
+                entity_funcs::stopSound(entity, entity_state::stateToString(entity_state::MOVE));
+            }
+        });
+}
+
+void TargetFollow::setThreadPool(ThreadPool *thread_pool)
+{
+    m_path_requests.setThreadPool(thread_pool);
 }
 
 void TargetFollow::onMapChanged(map::Map *map)
@@ -163,6 +206,8 @@ void TargetFollow::onMapChanged(map::Map *map)
     m_map = map;
     m_walls = nullptr;
     m_wall_size = {};
+    m_flow_fields.clear();
+    m_path_requests.clear();
 }
 
 void TargetFollow::onChunkChanged(const sf::Vector2i &chunk_coords)
@@ -173,6 +218,8 @@ void TargetFollow::onChunkChanged(const sf::Vector2i &chunk_coords)
     const map::Chunk *chunk = m_map->getChunks().getData(chunk_coords);
     m_walls = &chunk->getWalls();
     m_wall_size = chunk->getWallSize();
+    m_path_requests.setWalls(*m_walls);
+    m_flow_fields.clear();
 }
 
 sf::Vector2i TargetFollow::transformPosition(const sf::Vector2f &position)
@@ -183,4 +230,79 @@ sf::Vector2i TargetFollow::transformPosition(const sf::Vector2f &position)
     return {int32_t(position.x) / m_wall_size.x, int32_t(position.y) / m_wall_size.y};
 }
 
+void TargetFollow::deliverPaths()
+{
+    for (PathRequests::Result &result : m_path_requests.update())
+    {
+        // Stale path is kept if search is stopped by nodes limit
+        if (!result.complete || !result.owner.isValid()
+            || !result.owner.has<component::TargetFollow>())
+            continue;
+
+        auto &target_follow_component = result.owner.get<component::TargetFollow>();
+        if (!target_follow_component.follow)
+            continue;
+
+        target_follow_component.path = std::move(result.path);
+        if (!target_follow_component.path.empty())
+            target_follow_component.path.erase(target_follow_component.path.end() - 1);
+    }
+}
+
+void TargetFollow::countTargetFollowers()
+{
+    m_target_followers.clear();
+    for (TargetFlowField &target_flow_field : m_flow_fields)
+        target_flow_field.used = false;
+
+    if (!m_walls)
+        return;
+
+    each<component::TargetFollow, component::Transform, component::Velocity, component::State>(
+        [this](
+            Entity &entity,
+            component::TargetFollow &target_follow_component,
+            component::Transform &transform_component,
+            component::Velocity &velocity_component,
+            component::State &state_component) {
+            if (target_follow_component.follow)
+                ++m_target_followers[cellKey(transformPosition(target_follow_component.target))];
+        });
+}
+
+FlowField &TargetFollow::getFlowField(const sf::Vector2i &target_coord)
+{
+    // There are few followed targets at once, so linear search is enough
+    for (TargetFlowField &target_flow_field : m_flow_fields)
+    {
+        if (target_flow_field.flow_field.isValid()
+            && target_flow_field.flow_field.getTarget() == target_coord)
+        {
+            target_flow_field.used = true;
+            return target_flow_field.flow_field;
+        }
+    }
+
+    // Reuse field of target which isn't followed in this tick
+    auto target_flow_field_found = std::find_if(
+        m_flow_fields.begin(), m_flow_fields.end(), [](const TargetFlowField &target_flow_field) {
+            return !target_flow_field.used;
+        });
+
+    if (target_flow_field_found == m_flow_fields.end())
+    {
+        m_flow_fields.push_back({FlowField{*m_walls}, false});
+        target_flow_field_found = m_flow_fields.end() - 1;
+    }
+
+    target_flow_field_found->used = true;
+    target_flow_field_found->flow_field.update(target_coord);
+    return target_flow_field_found->flow_field;
+}
+
+uint64_t TargetFollow::cellKey(const sf::Vector2i &coord)
+{
+    return (uint64_t(uint32_t(coord.x)) << 32) | uint32_t(coord.y);
+}
+
 } // namespace fck::system
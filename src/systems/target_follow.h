@@ -2,11 +2,16 @@
 #define TARGETFOLLOW_UDCGQLCESNUY_H
 
 #include "../components/components.h"
+#include "../fck/a_star.h"
+#include "../fck/flow_field.h"
+#include "../fck/path_requests.h"
 #include "../fck/system.h"
 #include "../fck/vector_2d.h"
 #include "../fck_common.h"
 #include "../map/map.h"
 
+#include <unordered_map>
+
 namespace fck::system
 {
 
@@ -22,6 +27,9 @@ public:
 
     void update(double delta_time);
 
+    // Path requests are searched on it, pool of scheduler which updates system
+    void setThreadPool(ThreadPool *thread_pool);
+
 public: //slots
     void onMapChanged(map::Map *map);
     void onChunkChanged(const sf::Vector2i &chunk_coords);
@@ -29,10 +37,32 @@ public: //slots
 private:
     sf::Vector2i transformPosition(const sf::Vector2f &position);
 
+    void deliverPaths();
+    void countTargetFollowers();
+    FlowField &getFlowField(const sf::Vector2i &target_coord);
+
+    static uint64_t cellKey(const sf::Vector2i &coord);
+
 private:
     map::Map *m_map;
     const Vector2D<int32_t> *m_walls;
     sf::Vector2i m_wall_size;
+
+    // Searches of followers with few co-followers, results come at next tick
+    PathRequests m_path_requests;
+
+    struct TargetFlowField
+    {
+        FlowField flow_field;
+        bool used;
+    };
+
+    // Targets followed by this count of entities share one flow field instead of searches,
+    // followers read their next cell from it every step
+    static constexpr int32_t FLOW_FIELD_MIN_FOLLOWERS = 4;
+
+    std::unordered_map<uint64_t, int32_t> m_target_followers;
+    std::vector<TargetFlowField> m_flow_fields;
 };
 
 } // namespace fck::system
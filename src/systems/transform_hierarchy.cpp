@@ -0,0 +1,141 @@
+#include "transform_hierarchy.h"
+
+#include "../entity_funcs.h"
+#include "../fck/world.h"
+
+namespace fck::system
+{
+
+TransformHierarchy::TransformHierarchy() : m_last_tick{0}
+{
+    // Buckets are changed by slots on main thread
+    setExclusive(false);
+    writes<component::Transform>();
+}
+
+void TransformHierarchy::update(double delta_time)
+{
+    // Changes made after previous update have its tick or later
+    uint32_t last_tick = m_last_tick;
+    m_last_tick = getWorld()->getTick();
+
+    for (std::vector<Entity> &children : m_depth_children)
+    {
+        for (Entity &entity : children)
+        {
+            auto &transform_component = entity.get<component::Transform>();
+
+            const Entity &parent = transform_component.parent;
+            if (!parent.isValid() || !parent.has<component::Transform>())
+                continue;
+
+            if (parent.getChangedTick<component::Transform>() < last_tick)
+                continue;
+
+            sf::Vector2f position = parent.get<component::Transform>().transform.getPosition()
+                + transform_component.local_position;
+            sf::Vector2f offset = position - transform_component.transform.getPosition();
+
+            if (offset == sf::Vector2f{})
+                continue;
+
+            transform_component.transform.move(offset);
+            entity.markChanged<component::Transform>();
+
+            entity_funcs::markMoved(entity, offset);
+        }
+    }
+}
+
+void TransformHierarchy::onEntityParentChanged(const Entity &entity, const Entity &parent)
+{
+    (void)(parent);
+    setSubtreeDepth(entity, getDepth(entity));
+}
+
+void TransformHierarchy::initialize()
+{
+    m_depth_children.clear();
+    m_child_positions.clear();
+}
+
+void TransformHierarchy::onEntityAdded(Entity &entity)
+{
+    // Depth follows from parents, so depths of added children are already right
+    getChildPosition(entity).added = true;
+    setDepth(entity, getDepth(entity));
+}
+
+void TransformHierarchy::onEntityRemoved(Entity &entity)
+{
+    setDepth(entity, 0);
+    getChildPosition(entity).added = false;
+}
+
+TransformHierarchy::ChildPosition &TransformHierarchy::getChildPosition(const Entity &entity)
+{
+    uint32_t index = entity.getId().getIndex();
+    if (m_child_positions.size() <= index)
+        m_child_positions.resize(index + 1, ChildPosition{false, 0, -1});
+
+    return m_child_positions[index];
+}
+
+void TransformHierarchy::setDepth(const Entity &entity, int32_t depth)
+{
+    ChildPosition &child_position = getChildPosition(entity);
+    if (!child_position.added || child_position.depth == depth)
+        return;
+
+    // Order within depth doesn't matter, last child takes place of removed one
+    if (child_position.depth > 0)
+    {
+        std::vector<Entity> &children = m_depth_children[child_position.depth];
+        if (child_position.position != int32_t(children.size()) - 1)
+        {
+            children[child_position.position] = children.back();
+            getChildPosition(children[child_position.position]).position = child_position.position;
+        }
+        children.pop_back();
+    }
+
+    child_position.depth = depth;
+    child_position.position = -1;
+
+    if (depth > 0)
+    {
+        if (int32_t(m_depth_children.size()) <= depth)
+            m_depth_children.resize(depth + 1);
+
+        child_position.position = int32_t(m_depth_children[depth].size());
+        m_depth_children[depth].push_back(entity);
+    }
+}
+
+void TransformHierarchy::setSubtreeDepth(const Entity &entity, int32_t depth)
+{
+    setDepth(entity, depth);
+
+    // Children which aren't added are walked too, their added children are below them
+    for (const Entity &child : entity.get<component::Transform>().children)
+    {
+        if (child.isValid() && child.has<component::Transform>())
+            setSubtreeDepth(child, depth + 1);
+    }
+}
+
+int32_t TransformHierarchy::getDepth(const Entity &entity) const
+{
+    int32_t depth = 0;
+
+    Entity parent = entity.get<component::Transform>().parent;
+    while (parent.isValid() && parent.has<component::Transform>())
+    {
+        ++depth;
+        parent = parent.get<component::Transform>().parent;
+    }
+
+    return depth;
+}
+
+} // namespace fck::system
@@ -0,0 +1,56 @@
+#ifndef TRANSFORMHIERARCHY_HCMWQOZRTXUA_H
+#define TRANSFORMHIERARCHY_HCMWQOZRTXUA_H
+
+#include "../components/components.h"
+
+#include "../fck/system.h"
+
+namespace fck::system
+{
+
+// Moves child entities after their parents. Children are kept in buckets by depth in hierarchy,
+// so one pass over them carries parent changes down to every level: a child is moved when
+// its parent Transform changed since previous update, which marks its own Transform changed.
+// Buckets are updated by added, removed and reparented entities only, reparented entity moves
+// its subtree.
+class TransformHierarchy : public System<component::Transform>
+{
+public:
+    TransformHierarchy();
+    ~TransformHierarchy() = default;
+
+    void update(double delta_time);
+
+public: // slots
+    void onEntityParentChanged(const Entity &entity, const Entity &parent);
+
+protected:
+    void initialize();
+    void onEntityAdded(Entity &entity);
+    void onEntityRemoved(Entity &entity);
+
+private:
+    struct ChildPosition
+    {
+        bool added;
+        // 0 if entity isn't child
+        int32_t depth;
+        int32_t position;
+    };
+
+    ChildPosition &getChildPosition(const Entity &entity);
+    void setDepth(const Entity &entity, int32_t depth);
+    void setSubtreeDepth(const Entity &entity, int32_t depth);
+    int32_t getDepth(const Entity &entity) const;
+
+private:
+    // Children of depth, bucket 0 is empty
+    std::vector<std::vector<Entity>> m_depth_children;
+    // By entity index
+    std::vector<ChildPosition> m_child_positions;
+    uint32_t m_last_tick;
+};
+
+} // namespace fck::system
+
+#endif // TRANSFORMHIERARCHY_HCMWQOZRTXUA_H
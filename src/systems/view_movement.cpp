@@ -11,6 +11,9 @@ namespace fck::system
 
 ViewMovement::ViewMovement() : m_view{nullptr}, m_velocity_mul{5}
 {
+    setExclusive(false);
+    reads<component::Transform>();
+    writes<component::Player>();
 }
 
 void ViewMovement::setView(sf::View *newView)